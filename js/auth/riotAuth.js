@@ -3,7 +3,7 @@
 // Import webextension-polyfill for cross-browser compatibility
 import '../../vendor/browser-polyfill.js';
 
-import { PersistentStorage } from '../core/persistentStorage.js';
+import { PersistentStorage, StorageMirror } from '../core/persistentStorage.js';
 import { TwitchAuth } from './twitchAuth.js';
 
 class ReAuthenticationRequiredError extends Error {
@@ -42,7 +42,7 @@ export const RiotAuth = {
       // Persist chosen platform routing value early so subsequent calls use it
       try {
         if (region) {
-          await browser.storage.local.set({ selectedRegion: region });
+          await StorageMirror.set({ selectedRegion: region });
         }
       } catch (_) {}
       
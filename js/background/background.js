@@ -4,31 +4,365 @@
 
 // Import webextension-polyfill for cross-browser compatibility
 import '../../vendor/browser-polyfill.js';
+import '../core/metrics.js';
 
 import { RiotAuth } from '../auth/riotAuth.js';
 import { TwitchAuth } from '../auth/twitchAuth.js';
-import { PersistentStorage } from '../core/persistentStorage.js';
+import { PersistentStorage, StorageMirror } from '../core/persistentStorage.js';
 
 // Removed RIOT_AUTH_URL constant - no longer needed with server-side auth
 const RANK_WORKER_API_URL = 'https://eloward-ranks.unleashai.workers.dev';
-const MAX_RANK_CACHE_SIZE = 2000;
+const MAX_RANK_CACHE_SIZE = 10000; // Entries are packed (see PackedRankStore), so this costs well under 1 MB
+// Rank cache keys older versions kept in storage.local; removed on startup
 const RANK_CACHE_STORAGE_KEY = 'eloward_rank_cache';
 const RANK_CACHE_UPDATED_AT_KEY = 'eloward_rank_cache_last_updated';
-const RANK_CACHE_EXPIRY = 60 * 60 * 1000;
+const RANK_CACHE_SHARD_COUNT = 16; // Hashed shards of the session snapshot
+const RANK_CACHE_SHARD_KEYS = Array.from({ length: RANK_CACHE_SHARD_COUNT }, (_, index) => `eloward_rank_cache_shard_${index}`);
+const RANK_CACHE_FLUSH_IDLE_MS = 2000; // Flush once writes have been quiet this long
+const RANK_CACHE_FLUSH_MAX_DELAY_MS = 10000; // ...but never hold dirty entries longer than this
+const RANK_CACHE_PORT_NAME = 'eloward_rank_cache'; // Long-lived port used to mirror the cache into tabs
+const RANK_CACHE_SNAPSHOT_LIMIT = 500; // Most-used entries sent to a tab on connect, besides its channel's viewers
+const RANK_SNAPSHOT_STORAGE_KEY = 'eloward_rank_cache_snapshot'; // v2 single-key snapshot, dropped on restore
+const RANK_SNAPSHOT_META_KEY = 'eloward_rank_cache_snapshot_meta'; // { v, currentUser } (storage.session)
+const RANK_SNAPSHOT_SHARD_KEYS = Array.from({ length: RANK_CACHE_SHARD_COUNT }, (_, index) => `eloward_rank_cache_snapshot_${index}`);
+const RANK_SNAPSHOT_VERSION = 3; // v3: one key per shard, rank data as PackedRankStore tuples
+const WARM_START_SAMPLES_KEY = 'eloward_warm_start_samples';
+const WARM_START_SAMPLE_LIMIT = 20;
+// Actions that read or write userRankCache; only these wait for the warm-start restore
+const RANK_CACHE_ACTIONS = new Set([
+  'fetch_rank_for_username', 'fetch_ranks_for_usernames', 'get_all_cached_ranks', 'revalidate_ranks',
+  'prefetch_channel_ranks', 'set_current_user', 'set_rank_data', 'clear_rank_cache',
+  'clear_rank_cache_except_current_user', 'clear_user_rank_cache', 'prune_unranked_rank_cache',
+  'update_user_cache_option', 'refresh_options_data'
+]);
+const TAB_REGISTRY_STORAGE_KEY = 'eloward_tab_registry';
+// Entries are fresh for a TTL that depends on what they hold, then served stale (and revalidated
+// in the background) for RANK_CACHE_STALE_GRACE_MS before being dropped outright
+const RANK_CACHE_TTL_POSITIVE_MS = 60 * 60 * 1000;
+const RANK_CACHE_TTL_UNRANKED_MS = 30 * 60 * 1000;
+const RANK_CACHE_TTL_NEGATIVE_MS = 20 * 60 * 1000;
+const RANK_CACHE_TTL_JITTER = 0.1; // +/-10% so entries cached together don't go stale together
+const RANK_CACHE_STALE_GRACE_MS = 6 * 60 * 60 * 1000;
+const RANK_CACHE_REVALIDATE_RETRY_MS = 30 * 1000; // Minimum gap between refresh attempts for one entry
+const RANK_CACHE_WHEEL_SLOT_MS = 60 * 1000; // Expiry wheel granularity
 const RANK_REFRESH_INTERVAL_MS = 30 * 60 * 1000; // 30 minutes
+const RANK_REFRESH_ALARM = 'eloward_rank_refresh';
+const RANK_REFRESH_STATE_KEY = 'eloward_rank_refresh_state'; // Activity and backoff (storage.session)
+const RANK_REFRESH_ACTIVE_WINDOW_MS = 15 * 60 * 1000; // Keep refreshing this long after the user last chatted
+const RANK_REFRESH_RETRY_BASE_MS = 60 * 1000;
+const RANK_REFRESH_RETRY_MAX_MS = RANK_REFRESH_INTERVAL_MS;
+// Storage the popup view model is derived from; any change rebuilds it
+const POPUP_VIEW_MODEL_KEYS = [
+  'eloward_persistent_twitch_user_data',
+  'eloward_persistent_riot_user_data',
+  'eloward_user_options',
+  'selectedRegion',
+  'accountSectionCollapsed',
+  'optionsSectionCollapsed'
+];
+const RANK_BATCH_WINDOW_MS = 25; // Coalescing window for rank lookups
+const RANK_BATCH_MAX_SIZE = 50; // Flush early once this many usernames are queued
+const CHANNEL_PREFETCH_LIMIT = 200; // Linked accounts to warm per channel entry
+const CHANNEL_PREFETCH_COOLDOWN_MS = 10 * 60 * 1000; // Re-entering a channel within this window reuses the warm cache
+
+// Second stage of the Twitch content script, injected when js/content/bootstrap.js asks for it.
+// Keep in sync with INJECTED_SCRIPTS in scripts/build-manifest.js
+const CHAT_ENGINE_FILES = ['js/core/metrics.js', 'js/core/storageMirror.js', 'js/content/content.js'];
+
+const VIEWER_BACKEND_URL = 'https://eloward-users.unleashai.workers.dev';
+const VIEWER_OUTBOX_STORAGE_KEY = 'eloward_viewer_qualify_outbox';
+const VIEWER_OUTBOX_RETENTION_MS = 48 * 60 * 60 * 1000; // Current + previous viewer window
+const VIEWER_UPLOAD_BATCH_WINDOW_MS = 2000; // Coalesce qualifications arriving from several tabs
+const VIEWER_UPLOAD_BATCH_MAX_SIZE = 25;
+const VIEWER_UPLOAD_RETRY_BASE_MS = 5000;
+const VIEWER_UPLOAD_RETRY_MAX_MS = 10 * 60 * 1000;
+const VIEWER_UPLOAD_ALARM = 'eloward_viewer_upload_retry'; // Backs the retry timer if the worker is stopped
+
+// Badge bytes live in the extension's own Cache Storage; tabs ask for them with 'get_badge_asset'
+const BADGE_CDN_BASE = 'https://eloward-cdn.unleashai.workers.dev';
+const BADGE_STORE_PREFIX = 'eloward-badges-'; // One per-tier store per badge version: eloward-badges-v<version>
+const BADGE_PACK_STORE_NAME = 'eloward-badge-pack'; // Pack assets, addressed by hash
+const BADGE_PACK_STATE_KEY = 'eloward_badge_pack_missing'; // { version, at } of a manifest 404 (storage.session)
+const BADGE_PACK_MISSING_TTL_MS = 12 * 60 * 60 * 1000; // Bounds the 404 where storage.session falls back to local
+const BADGE_PACK_RETRY_MS = 5 * 60 * 1000; // Retry a pack that failed to load (network, malformed) after this
 
 // Special marker to indicate a user has no rank data (negative cache)
 const NO_RANK_MARKER = { __noRank: true, __cacheType: 'negative' };
 
+// Enum tables for the packed rank columns. Code 0 means "absent"; a value missing from its
+// table keeps that entry as a plain object in PackedRankStore.overflow instead.
+const RANK_TIER_CODES = [null, 'IRON', 'BRONZE', 'SILVER', 'GOLD', 'PLATINUM', 'EMERALD', 'DIAMOND', 'MASTER', 'GRANDMASTER', 'CHALLENGER', 'UNRANKED'];
+const RANK_DIVISION_CODES = [null, 'I', 'II', 'III', 'IV'];
+const RANK_REGION_CODES = [null, 'na1', 'euw1', 'eun1', 'kr', 'br1', 'jp1', 'la1', 'la2', 'oc1', 'tr1', 'ru', 'me1', 'ph2', 'sg2', 'th2', 'tw2', 'vn2'];
+const RANK_PACKED_FIELDS = new Set(['tier', 'division', 'leaguePoints', 'summonerName', 'region', 'animate_badge']);
+
+const RANK_SLOT_EMPTY = 0;
+const RANK_SLOT_NEGATIVE = 1;
+const RANK_SLOT_PACKED = 2;
+const RANK_SLOT_OVERFLOW = 3;
+
+const RANK_FLAG_ANIMATE = 1;
+const RANK_FLAG_ANIMATE_SET = 2; // animate_badge was present (even if false)
+
+// FNV-1a; stable across sessions so a username always lands in the same shard
+function rankCacheShardFor(username) {
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < username.length; i++) {
+    hash ^= username.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return (hash >>> 0) % RANK_CACHE_SHARD_COUNT;
+}
+
+function rankEnumCode(table, value) {
+  if (value === null || value === undefined) return 0;
+  const code = table.indexOf(value);
+  return code > 0 ? code : -1;
+}
+
+/**
+ * StringPool - reference-counted interning for repeated strings (riot IDs)
+ * Ids start at 1 so 0 can mean "no string" in a typed array column.
+ */
+class StringPool {
+  constructor() {
+    this.ids = new Map(); // string -> id
+    this.strings = [null];
+    this.refCounts = [0];
+    this.freeIds = [];
+  }
+
+  acquire(value) {
+    let id = this.ids.get(value);
+    if (id === undefined) {
+      id = this.freeIds.length > 0 ? this.freeIds.pop() : this.strings.length;
+      this.strings[id] = value;
+      this.refCounts[id] = 0;
+      this.ids.set(value, id);
+    }
+    this.refCounts[id]++;
+    return id;
+  }
+
+  release(id) {
+    if (!id) return;
+    if (--this.refCounts[id] > 0) return;
+    this.ids.delete(this.strings[id]);
+    this.strings[id] = null;
+    this.freeIds.push(id);
+  }
+
+  lookup(id) {
+    return id ? this.strings[id] : null;
+  }
+}
+
+/**
+ * PackedRankStore - columnar storage for rank entries, one typed-array row per slot
+ * Tier, division and region are enum codes, LP is numeric and riot IDs are interned, so an
+ * entry costs a few dozen bytes instead of two objects; rank objects are only materialized
+ * by decode() when a caller actually needs one.
+ */
+class PackedRankStore {
+  constructor(initialCapacity = 256) {
+    this.capacity = 0;
+    this.nextSlot = 0;
+    this.freeSlots = [];
+    this.riotIds = new StringPool();
+    this.overflow = new Map(); // slot -> rank object that does not fit the packed columns
+    this.grow(initialCapacity);
+  }
+
+  grow(capacity) {
+    const resize = (Type, previous) => {
+      const column = new Type(capacity);
+      if (previous) column.set(previous);
+      return column;
+    };
+    this.kind = resize(Uint8Array, this.kind);
+    this.tier = resize(Uint8Array, this.tier);
+    this.division = resize(Uint8Array, this.division);
+    this.region = resize(Uint8Array, this.region);
+    this.flags = resize(Uint8Array, this.flags);
+    this.leaguePoints = resize(Int32Array, this.leaguePoints);
+    this.riotId = resize(Uint32Array, this.riotId);
+    this.frequency = resize(Uint32Array, this.frequency);
+    this.wheelSlot = resize(Int32Array, this.wheelSlot);
+    this.timestamp = resize(Float64Array, this.timestamp);
+    this.staleAt = resize(Float64Array, this.staleAt);
+    this.expiresAt = resize(Float64Array, this.expiresAt);
+    this.nextRevalidateAt = resize(Float64Array, this.nextRevalidateAt);
+    this.capacity = capacity;
+  }
+
+  allocate() {
+    if (this.freeSlots.length > 0) return this.freeSlots.pop();
+    if (this.nextSlot >= this.capacity) this.grow(this.capacity * 2);
+    return this.nextSlot++;
+  }
+
+  free(slot) {
+    this.clearRank(slot);
+    this.kind[slot] = RANK_SLOT_EMPTY;
+    this.frequency[slot] = 0;
+    this.wheelSlot[slot] = -1;
+    this.nextRevalidateAt[slot] = 0;
+    this.freeSlots.push(slot);
+  }
+
+  reset() {
+    this.nextSlot = 0;
+    this.freeSlots = [];
+    this.riotIds = new StringPool();
+    this.overflow.clear();
+    this.kind.fill(RANK_SLOT_EMPTY);
+  }
+
+  clearRank(slot) {
+    this.riotIds.release(this.riotId[slot]);
+    this.riotId[slot] = 0;
+    this.overflow.delete(slot);
+  }
+
+  encode(slot, rankData) {
+    this.clearRank(slot);
+
+    if (rankData === NO_RANK_MARKER || !rankData) {
+      this.kind[slot] = RANK_SLOT_NEGATIVE;
+      return;
+    }
+
+    const tier = rankEnumCode(RANK_TIER_CODES, rankData.tier);
+    const division = rankEnumCode(RANK_DIVISION_CODES, rankData.division);
+    const region = rankEnumCode(RANK_REGION_CODES, rankData.region);
+    const lp = rankData.leaguePoints;
+    const packable = tier >= 0 && division >= 0 && region >= 0 &&
+      (lp === null || lp === undefined || (Number.isInteger(lp) && lp >= 0)) &&
+      (rankData.summonerName === null || rankData.summonerName === undefined || typeof rankData.summonerName === 'string') &&
+      (rankData.animate_badge === undefined || typeof rankData.animate_badge === 'boolean') &&
+      Object.keys(rankData).every(key => RANK_PACKED_FIELDS.has(key));
+
+    if (!packable) {
+      this.kind[slot] = RANK_SLOT_OVERFLOW;
+      this.overflow.set(slot, rankData);
+      return;
+    }
+
+    this.kind[slot] = RANK_SLOT_PACKED;
+    this.tier[slot] = tier;
+    this.division[slot] = division;
+    this.region[slot] = region;
+    this.leaguePoints[slot] = lp === null || lp === undefined ? -1 : lp;
+    this.riotId[slot] = rankData.summonerName ? this.riotIds.acquire(rankData.summonerName) : 0;
+    this.flags[slot] = (rankData.animate_badge ? RANK_FLAG_ANIMATE : 0) |
+      (rankData.animate_badge !== undefined ? RANK_FLAG_ANIMATE_SET : 0);
+  }
+
+  decode(slot) {
+    switch (this.kind[slot]) {
+      case RANK_SLOT_NEGATIVE:
+        return NO_RANK_MARKER;
+      case RANK_SLOT_OVERFLOW:
+        return this.overflow.get(slot);
+      case RANK_SLOT_PACKED: {
+        const rankData = {
+          tier: RANK_TIER_CODES[this.tier[slot]] || undefined,
+          division: RANK_DIVISION_CODES[this.division[slot]] || undefined,
+          leaguePoints: this.leaguePoints[slot] >= 0 ? this.leaguePoints[slot] : undefined,
+          summonerName: this.riotIds.lookup(this.riotId[slot]) || undefined,
+          region: RANK_REGION_CODES[this.region[slot]] || undefined
+        };
+        if (this.flags[slot] & RANK_FLAG_ANIMATE_SET) {
+          rankData.animate_badge = !!(this.flags[slot] & RANK_FLAG_ANIMATE);
+        }
+        return rankData;
+      }
+      default:
+        return null;
+    }
+  }
+
+  isLowSignal(slot) {
+    const kind = this.kind[slot];
+    if (kind === RANK_SLOT_NEGATIVE) return true;
+    if (kind === RANK_SLOT_PACKED) {
+      const tier = RANK_TIER_CODES[this.tier[slot]];
+      return !tier || tier === 'UNRANKED';
+    }
+    const rankData = this.overflow.get(slot);
+    return !rankData?.tier || String(rankData.tier).toUpperCase() === 'UNRANKED';
+  }
+
+  // Compact, JSON-safe form for storage: 0 (negative), [tier, division, lp, riotId, region, flags]
+  // using the enum codes above, or the plain object for overflow entries
+  toTuple(slot) {
+    switch (this.kind[slot]) {
+      case RANK_SLOT_PACKED:
+        return [this.tier[slot], this.division[slot], this.leaguePoints[slot], this.riotIds.lookup(this.riotId[slot]), this.region[slot], this.flags[slot]];
+      case RANK_SLOT_OVERFLOW:
+        return this.overflow.get(slot);
+      default:
+        return 0;
+    }
+  }
+}
+
+function rankDataFromTuple(tuple) {
+  if (!tuple) return NO_RANK_MARKER;
+  if (!Array.isArray(tuple)) {
+    // Legacy serialized negative entries
+    return tuple.__noRank && tuple.__cacheType === 'negative' ? NO_RANK_MARKER : tuple;
+  }
+  const [tier, division, lp, riotId, region, flags] = tuple;
+  const rankData = {
+    tier: RANK_TIER_CODES[tier] || undefined,
+    division: RANK_DIVISION_CODES[division] || undefined,
+    leaguePoints: lp >= 0 ? lp : undefined,
+    summonerName: riotId || undefined,
+    region: RANK_REGION_CODES[region] || undefined
+  };
+  if (flags & RANK_FLAG_ANIMATE_SET) rankData.animate_badge = !!(flags & RANK_FLAG_ANIMATE);
+  return rankData;
+}
+
+function rankCacheTtlFor(rankData) {
+  let ttl = RANK_CACHE_TTL_POSITIVE_MS;
+  if (rankData === NO_RANK_MARKER || !rankData) {
+    ttl = RANK_CACHE_TTL_NEGATIVE_MS;
+  } else if (!rankData.tier || String(rankData.tier).toUpperCase() === 'UNRANKED') {
+    ttl = RANK_CACHE_TTL_UNRANKED_MS;
+  }
+  return Math.round(ttl * (1 + (Math.random() * 2 - 1) * RANK_CACHE_TTL_JITTER));
+}
+
 /**
  * UserRankCache - LFU cache for rank data with negative caching support
  * Caches both users with ranks and users without ranks (NO_RANK_MARKER)
+ *
+ * Entries live in frequency buckets kept as a sorted doubly-linked list, so get, set and
+ * evict are constant-time regardless of cache size. Expiry is tracked separately in a
+ * time wheel of RANK_CACHE_WHEEL_SLOT_MS slots that is advanced lazily on access.
+ *
+ * Past staleAt an entry is still returned, but get() asks onStale to refresh it; the wheel
+ * only removes entries once their stale grace period (expiresAt) has run out as well.
+ *
+ * Rank data and per-entry bookkeeping live in a PackedRankStore; the cache itself only
+ * maps usernames to store slots.
  */
 class UserRankCache {
   constructor(maxSize = MAX_RANK_CACHE_SIZE) {
-    this.cache = new Map();
+    this.cache = new Map(); // username -> store slot
+    this.store = new PackedRankStore();
     this.maxSize = maxSize;
     this.currentUser = null;
+    this.onStale = null; // (username) => void, wired to the lookup pipeline
+
+    // Lowest-frequency bucket first; each bucket keeps usernames in insertion order
+    this.bucketHead = null;
+    this.buckets = new Map(); // frequency -> bucket
+
+    this.expiryWheel = new Map(); // slot -> Set of usernames expiring within that slot
+    this.wheelCursor = Math.floor(Date.now() / RANK_CACHE_WHEEL_SLOT_MS);
   }
 
   setCurrentUser(username) {
@@ -40,113 +374,1637 @@ class UserRankCache {
   get(username) {
     if (!username) return null;
     const normalizedUsername = username.toLowerCase();
-    const entry = this.cache.get(normalizedUsername);
+    const now = Date.now();
+    this.expireStale(now);
+
+    const slot = this.cache.get(normalizedUsername);
+
+    if (slot !== undefined) {
+      if (this.store.expiresAt[slot] <= now) {
+        this.remove(normalizedUsername);
+        return null;
+      }
+
+      this.touch(normalizedUsername, slot);
+      if (this.store.staleAt[slot] <= now) {
+        EloWardMetrics.count('rank_cache.stale_hit');
+        this.revalidate(normalizedUsername, slot, now);
+      }
+      
+      // Return the rank data, which could be actual rank data or NO_RANK_MARKER (possibly stale)
+      const rankData = this.store.decode(slot);
+      EloWardMetrics.count(rankData === NO_RANK_MARKER ? 'rank_cache.negative_hit' : 'rank_cache.hit');
+      return rankData;
+    }
+
+    EloWardMetrics.count('rank_cache.miss');
+    return null;
+  }
+
+  revalidate(username, slot, now = Date.now()) {
+    if (!this.onStale || this.store.nextRevalidateAt[slot] > now) return;
+    this.store.nextRevalidateAt[slot] = now + RANK_CACHE_REVALIDATE_RETRY_MS;
+    this.onStale(username);
+  }
+
+  // Refresh stale entries on request (e.g. a tab served them from its mirror)
+  revalidateIfStale(username) {
+    if (!username) return;
+    const normalizedUsername = username.toLowerCase();
+    const slot = this.cache.get(normalizedUsername);
+    const now = Date.now();
+    if (slot !== undefined && this.store.expiresAt[slot] > now && this.store.staleAt[slot] <= now) {
+      this.revalidate(normalizedUsername, slot, now);
+    }
+  }
+
+  // Age entries out immediately without dropping them; the current user is left alone.
+  // lowSignalOnly limits this to negative and unranked entries. Tabs hear about it as one
+  // rank_cache_stale message and apply the same rule to their mirrors.
+  markStale({ lowSignalOnly = false } = {}) {
+    const now = Date.now();
+    let marked = 0;
+    for (const [username, slot] of this.cache.entries()) {
+      if (username === this.currentUser || this.store.expiresAt[slot] <= now || this.store.staleAt[slot] <= now) continue;
+      if (lowSignalOnly && !this.store.isLowSignal(slot)) continue;
+      this.store.staleAt[slot] = now;
+      marked++;
+    }
+    if (marked > 0) notifyRankCacheStale({ at: now, except: this.currentUser, lowSignalOnly });
+    return marked;
+  }
+
+  staleAtFor(username) {
+    const slot = username ? this.cache.get(username.toLowerCase()) : undefined;
+    return slot !== undefined ? this.store.staleAt[slot] : 0;
+  }
+
+  // Read an entry without counting it as a use
+  peek(username) {
+    if (!username) return null;
+    const slot = this.cache.get(username.toLowerCase());
+    if (slot === undefined || this.store.expiresAt[slot] <= Date.now()) return null;
+    return this.store.decode(slot);
+  }
+
+  set(username, rankData) {
+    if (!username) return;
+
+    this.write(username, rankData);
+  }
+
+  // Fill many entries (positive and negative) in one pass
+  setMany(rankDataByUsername) {
+    for (const [username, rankData] of Object.entries(rankDataByUsername)) {
+      if (username) {
+        this.write(username, rankData);
+      }
+    }
+  }
+
+  // Re-insert an entry loaded from storage, keeping its original frequency and age
+  restore(username, rankData, frequency = 1, timestamp = Date.now()) {
+    if (!username) return;
+    const normalizedUsername = username.toLowerCase();
+    if (this.cache.has(normalizedUsername)) return;
+
+    const staleAt = timestamp + rankCacheTtlFor(rankData);
+    const expiresAt = staleAt + RANK_CACHE_STALE_GRACE_MS;
+    if (expiresAt <= Date.now()) return;
+
+    this.insert(normalizedUsername, rankData, Math.max(1, frequency), timestamp, staleAt, expiresAt);
+    if (this.cache.size > this.maxSize) {
+      this.evictLFU(normalizedUsername);
+    }
+  }
+
+  write(username, rankData) {
+    // Allow caching of null/undefined results as negative cache entries
+    const dataToCache = rankData || NO_RANK_MARKER;
+
+    const normalizedUsername = username.toLowerCase();
+    const now = Date.now();
+    this.expireStale(now);
+
+    const slot = this.cache.get(normalizedUsername);
+    const staleAt = now + rankCacheTtlFor(dataToCache);
+
+    if (slot !== undefined) {
+      this.store.encode(slot, dataToCache);
+      this.store.timestamp[slot] = now;
+      this.store.staleAt[slot] = staleAt;
+      this.store.nextRevalidateAt[slot] = 0;
+      this.schedule(normalizedUsername, slot, staleAt + RANK_CACHE_STALE_GRACE_MS);
+      this.touch(normalizedUsername, slot);
+      notifyRankCacheChange(normalizedUsername);
+      return;
+    }
+
+    this.insert(normalizedUsername, dataToCache, 1, now, staleAt, staleAt + RANK_CACHE_STALE_GRACE_MS);
+    notifyRankCacheChange(normalizedUsername);
+
+    if (this.cache.size > this.maxSize) {
+      this.evictLFU(normalizedUsername);
+    }
+  }
+
+  delete(username) {
+    if (!username) return false;
+    return this.remove(username.toLowerCase());
+  }
+
+  clear() {
+    const currentUserSlot = this.currentUser ? this.cache.get(this.currentUser) : undefined;
+    const preserved = currentUserSlot === undefined ? null : {
+      rankData: this.store.decode(currentUserSlot),
+      frequency: this.store.frequency[currentUserSlot],
+      timestamp: this.store.timestamp[currentUserSlot],
+      staleAt: this.store.staleAt[currentUserSlot],
+      expiresAt: this.store.expiresAt[currentUserSlot]
+    };
+
+    this.cache.clear();
+    this.store.reset();
+    this.bucketHead = null;
+    this.buckets.clear();
+    this.expiryWheel.clear();
+
+    // Preserve current user entry to prevent loss of local user data
+    if (preserved) {
+      this.insert(this.currentUser, preserved.rankData, preserved.frequency, preserved.timestamp, preserved.staleAt, preserved.expiresAt);
+    }
+
+    notifyRankCacheReset();
+  }
+
+  evictLFU(protectedUsername = null) {
+    let bucket = this.bucketHead;
+
+    while (bucket && this.cache.size > this.maxSize) {
+      // Oldest key in the lowest-frequency bucket, never the current user or the entry just written
+      let userToEvict = null;
+      for (const key of bucket.keys) {
+        if (key !== this.currentUser && key !== protectedUsername) {
+          userToEvict = key;
+          break;
+        }
+      }
+
+      if (!userToEvict) {
+        bucket = bucket.next;
+        continue;
+      }
+
+      const nextBucket = bucket.keys.size === 1 ? bucket.next : bucket;
+      this.remove(userToEvict);
+      bucket = nextBucket;
+    }
+  }
+
+  has(username) {
+    if (!username) return false;
+    const normalizedUsername = username.toLowerCase();
+
+    const slot = this.cache.get(normalizedUsername);
+    if (slot !== undefined && this.store.expiresAt[slot] <= Date.now()) {
+      this.remove(normalizedUsername);
+      return false;
+    }
+
+    return slot !== undefined;
+  }
+
+  // Lightweight per-entry view; rankData is decoded only if read
+  view(slot) {
+    const store = this.store;
+    return {
+      get rankData() { return store.decode(slot); },
+      get tuple() { return store.toTuple(slot); },
+      get lowSignal() { return store.isLowSignal(slot); },
+      frequency: store.frequency[slot],
+      timestamp: store.timestamp[slot],
+      staleAt: store.staleAt[slot],
+      expiresAt: store.expiresAt[slot]
+    };
+  }
+
+  // Highest-frequency entries first, so callers can take just the hot part of the cache
+  *hottest(limit) {
+    let bucket = this.bucketHead;
+    while (bucket?.next) bucket = bucket.next;
+    const now = Date.now();
+    let yielded = 0;
+    for (; bucket && yielded < limit; bucket = bucket.prev) {
+      for (const username of bucket.keys) {
+        const slot = this.cache.get(username);
+        if (slot === undefined || this.store.expiresAt[slot] <= now) continue;
+        yield [username, this.view(slot)];
+        if (++yielded >= limit) return;
+      }
+    }
+  }
+
+  *entries() {
+    const now = Date.now();
+    for (const [username, slot] of this.cache.entries()) {
+      if (this.store.expiresAt[slot] > now) {
+        yield [username, this.view(slot)];
+      }
+    }
+  }
+
+  get size() {
+    return this.cache.size;
+  }
+
+  insert(username, rankData, frequency, timestamp, staleAt, expiresAt) {
+    const slot = this.store.allocate();
+    this.cache.set(username, slot);
+    this.store.encode(slot, rankData);
+    this.store.frequency[slot] = frequency;
+    this.store.timestamp[slot] = timestamp;
+    this.store.staleAt[slot] = staleAt;
+    this.store.nextRevalidateAt[slot] = 0;
+    this.store.wheelSlot[slot] = -1;
+
+    // New entries join the bucket matching their frequency, searching from the head
+    let bucket = this.buckets.get(frequency);
+    if (!bucket) {
+      let previous = null;
+      let candidate = this.bucketHead;
+      while (candidate && candidate.frequency < frequency) {
+        previous = candidate;
+        candidate = candidate.next;
+      }
+      bucket = this.linkBucket(frequency, previous);
+    }
+    bucket.keys.add(username);
+
+    this.schedule(username, slot, expiresAt);
+  }
+
+  remove(username) {
+    const slot = this.cache.get(username);
+    if (slot === undefined) return false;
+
+    this.cache.delete(username);
+    notifyRankCacheChange(username);
+
+    const bucket = this.buckets.get(this.store.frequency[slot]);
+    if (bucket) {
+      bucket.keys.delete(username);
+      if (bucket.keys.size === 0) this.unlinkBucket(bucket);
+    }
+
+    const wheelSlot = this.store.wheelSlot[slot];
+    const slotKeys = this.expiryWheel.get(wheelSlot);
+    if (slotKeys) {
+      slotKeys.delete(username);
+      if (slotKeys.size === 0) this.expiryWheel.delete(wheelSlot);
+    }
+
+    this.store.free(slot);
+    return true;
+  }
+
+  // Move an entry to the next frequency bucket
+  touch(username, slot) {
+    const frequency = this.store.frequency[slot];
+    const bucket = this.buckets.get(frequency);
+    const nextFrequency = frequency + 1;
+    this.store.frequency[slot] = nextFrequency;
+
+    let nextBucket = bucket.next;
+    if (!nextBucket || nextBucket.frequency !== nextFrequency) {
+      nextBucket = this.linkBucket(nextFrequency, bucket);
+    }
+    nextBucket.keys.add(username);
+
+    bucket.keys.delete(username);
+    if (bucket.keys.size === 0) this.unlinkBucket(bucket);
+  }
+
+  linkBucket(frequency, previous) {
+    const bucket = { frequency, keys: new Set(), prev: previous, next: previous ? previous.next : this.bucketHead };
+    if (bucket.next) bucket.next.prev = bucket;
+    if (previous) {
+      previous.next = bucket;
+    } else {
+      this.bucketHead = bucket;
+    }
+    this.buckets.set(frequency, bucket);
+    return bucket;
+  }
+
+  unlinkBucket(bucket) {
+    if (bucket.prev) {
+      bucket.prev.next = bucket.next;
+    } else {
+      this.bucketHead = bucket.next;
+    }
+    if (bucket.next) bucket.next.prev = bucket.prev;
+    bucket.prev = null;
+    bucket.next = null;
+    if (this.buckets.get(bucket.frequency) === bucket) this.buckets.delete(bucket.frequency);
+  }
+
+  // Place an entry in the expiry wheel slot for its deadline
+  schedule(username, slot, expiresAt) {
+    const wheelSlot = Math.floor(expiresAt / RANK_CACHE_WHEEL_SLOT_MS);
+    this.store.expiresAt[slot] = expiresAt;
+    const previousSlot = this.store.wheelSlot[slot];
+    if (previousSlot === wheelSlot) return;
+
+    const previousKeys = this.expiryWheel.get(previousSlot);
+    if (previousKeys) {
+      previousKeys.delete(username);
+      if (previousKeys.size === 0) this.expiryWheel.delete(previousSlot);
+    }
+
+    let slotKeys = this.expiryWheel.get(wheelSlot);
+    if (!slotKeys) {
+      slotKeys = new Set();
+      this.expiryWheel.set(wheelSlot, slotKeys);
+    }
+    slotKeys.add(username);
+    this.store.wheelSlot[slot] = wheelSlot;
+  }
+
+  // Drop every entry in wheel slots that have fully elapsed
+  expireStale(now = Date.now()) {
+    const currentSlot = Math.floor(now / RANK_CACHE_WHEEL_SLOT_MS);
+    if (this.wheelCursor >= currentSlot) return;
+
+    // After a long idle gap, visit only occupied slots instead of every elapsed one
+    const elapsedSlots = currentSlot - this.wheelCursor;
+    const slots = elapsedSlots > this.expiryWheel.size
+      ? Array.from(this.expiryWheel.keys()).filter(slot => slot < currentSlot)
+      : Array.from({ length: elapsedSlots }, (_, index) => this.wheelCursor + index);
+
+    for (const slot of slots) {
+      const slotKeys = this.expiryWheel.get(slot);
+      if (!slotKeys) continue;
+      for (const username of Array.from(slotKeys)) {
+        this.remove(username);
+      }
+      this.expiryWheel.delete(slot);
+    }
+
+    this.wheelCursor = currentSlot;
+  }
+}
+
+// Last chance to write pending snapshot shards before the service worker/event page is torn down
+if (browser.runtime.onSuspend) {
+  browser.runtime.onSuspend.addListener(() => {
+    rankCacheSnapshot.write().catch(() => {});
+  });
+}
+
+/**
+ * rankCacheSync - pushes the rank cache to content scripts over RANK_CACHE_PORT_NAME ports
+ * A tab names its channel in a 'rank_cache_subscribe' message and receives a snapshot of that
+ * channel's known viewers plus the RANK_CACHE_SNAPSHOT_LIMIT most-used entries, then coalesced
+ * deltas, so most cache checks in the content script need no message round trip. Anyone else
+ * is looked up on a miss. Deltas are filtered per port to the users that tab can show: its
+ * snapshot, its channel's viewers and whatever it looked up. Unranked users are sent as null.
+ */
+const rankCacheSync = {
+  ports: new Map(), // port -> { tabId, channel, usernames: Set }, once subscribed
+  changedUsernames: new Set(),
+  resetPending: false,
+  flushTimer: null,
+
+  serialize(rankData) {
+    return rankData === NO_RANK_MARKER ? null : rankData;
+  },
+
+  snapshot(channel) {
+    const ranks = {};
+    const staleAt = {};
+    const usernames = [...channelRankPrefetcher.membersOf(channel)];
+    if (userRankCache.currentUser) usernames.push(userRankCache.currentUser);
+    for (const username of usernames) {
+      const rankData = userRankCache.peek(username);
+      if (!rankData) continue;
+      ranks[username] = this.serialize(rankData);
+      staleAt[username] = userRankCache.staleAtFor(username);
+    }
+    for (const [username, entry] of userRankCache.hottest(RANK_CACHE_SNAPSHOT_LIMIT)) {
+      if (username in ranks) continue;
+      ranks[username] = this.serialize(entry.rankData);
+      staleAt[username] = entry.staleAt;
+    }
+    return { type: 'rank_cache_snapshot', ranks, staleAt };
+  },
+
+  connect(port) {
+    port.onDisconnect.addListener(() => {
+      this.ports.delete(port);
+    });
+    port.onMessage.addListener((message) => {
+      if (message?.type !== 'rank_cache_subscribe') return;
+      const channel = message.channel ? String(message.channel).toLowerCase() : null;
+      const snapshot = this.snapshot(channel);
+      this.ports.set(port, { tabId: port.sender?.tab?.id, channel, usernames: new Set(Object.keys(snapshot.ranks)) });
+      try { port.postMessage(snapshot); } catch (_) { this.ports.delete(port); return; }
+      EloWardMetrics.count('ipc.port.rank_cache_snapshot');
+      if (Object.values(snapshot.ranks).some(Boolean)) warmStart.noteRankServed(true);
+    });
+  },
+
+  // Usernames a tab looked up, so later changes to them reach that tab's mirror
+  noteInterest(tabId, usernames) {
+    if (tabId === undefined || tabId === null) return;
+    for (const record of this.ports.values()) {
+      if (record.tabId !== tabId) continue;
+      for (const username of usernames) record.usernames.add(String(username).toLowerCase());
+    }
+  },
+
+  wants(record, username) {
+    return record.usernames.has(username) || username === userRankCache.currentUser ||
+      channelRankPrefetcher.membersOf(record.channel).has(username);
+  },
+
+  noteChange(username) {
+    if (this.ports.size === 0) return;
+    this.changedUsernames.add(username);
+    this.scheduleFlush();
+  },
+
+  // A bulk markStale goes out as its rule, not as a delta carrying every entry
+  noteStale({ at, except, lowSignalOnly }) {
+    if (this.ports.size === 0) return;
+    const message = { type: 'rank_cache_stale', at, except: except || null, lowSignalOnly: !!lowSignalOnly };
+    for (const port of Array.from(this.ports.keys())) {
+      try { port.postMessage(message); } catch (_) { this.ports.delete(port); }
+    }
+    EloWardMetrics.count('ipc.port.rank_cache_stale', this.ports.size);
+  },
+
+  noteReset() {
+    if (this.ports.size === 0) return;
+    this.resetPending = true;
+    this.changedUsernames.clear();
+    this.scheduleFlush();
+  },
+
+  scheduleFlush() {
+    if (this.flushTimer) return;
+    // Coalesce everything written in the current task (e.g. a whole batch response)
+    this.flushTimer = setTimeout(() => {
+      this.flushTimer = null;
+      this.flush();
+    }, 0);
+  },
+
+  flush() {
+    if (this.resetPending) {
+      this.resetPending = false;
+      this.changedUsernames.clear();
+      // Each tab gets the snapshot for its own channel
+      for (const [port, record] of Array.from(this.ports)) {
+        const snapshot = this.snapshot(record.channel);
+        record.usernames = new Set(Object.keys(snapshot.ranks));
+        try { port.postMessage(snapshot); } catch (_) { this.ports.delete(port); }
+      }
+      EloWardMetrics.count('ipc.port.rank_cache_snapshot', this.ports.size);
+      return;
+    }
+
+    if (this.changedUsernames.size === 0) return;
+    const set = {};
+    const staleAt = {};
+    const removed = [];
+    for (const username of this.changedUsernames) {
+      const rankData = userRankCache.peek(username);
+      if (rankData) {
+        set[username] = this.serialize(rankData);
+        staleAt[username] = userRankCache.staleAtFor(username);
+      } else {
+        removed.push(username);
+      }
+    }
+    this.changedUsernames.clear();
+
+    let sent = 0;
+    for (const [port, record] of Array.from(this.ports)) {
+      const message = { type: 'rank_cache_delta', set: {}, staleAt: {}, removed: [] };
+      let size = 0;
+      for (const [username, rankData] of Object.entries(set)) {
+        if (!this.wants(record, username)) continue;
+        message.set[username] = rankData;
+        message.staleAt[username] = staleAt[username];
+        size++;
+      }
+      for (const username of removed) {
+        if (!this.wants(record, username)) continue;
+        message.removed.push(username);
+        size++;
+      }
+      if (size === 0) continue;
+      try { port.postMessage(message); sent++; } catch (_) { this.ports.delete(port); }
+    }
+    EloWardMetrics.count('ipc.port.rank_cache_delta', sent);
+  }
+};
+
+/**
+ * rankCacheSnapshot - compact copy of the in-memory rank cache that outlives service worker restarts
+ * Lives in storage.session (cleared with the browser session, so the cache still starts fresh
+ * each session) and falls back to storage.local where session storage is unavailable; restored
+ * entries keep their original timestamps, so expiry bounds staleness either way. Writes are lazy:
+ * entries are spread over RANK_CACHE_SHARD_COUNT keys by rankCacheShardFor, a mutation marks its
+ * shard dirty, and only dirty shards are rewritten once writes go idle or on suspend.
+ *
+ * Shard format: parallel arrays keyed by position, with ages instead of absolute timestamps and
+ * rank data as PackedRankStore.toTuple() enum tuples (0 for negative entries).
+ */
+const rankCacheSnapshot = {
+  dirtyShards: new Set(),
+  metaDirty: false,
+  idleTimer: null,
+  firstDirtyAt: 0,
+  writing: null,
+
+  area() {
+    return browser.storage.session || browser.storage.local;
+  },
+
+  encode(shards) {
+    const savedAt = Date.now();
+    const payload = {};
+    for (const shard of shards) {
+      payload[RANK_SNAPSHOT_SHARD_KEYS[shard]] = { v: RANK_SNAPSHOT_VERSION, savedAt, u: [], r: [], f: [], a: [] };
+    }
+    for (const [username, entry] of userRankCache.entries()) {
+      const snapshot = payload[RANK_SNAPSHOT_SHARD_KEYS[rankCacheShardFor(username)]];
+      if (!snapshot) continue;
+      snapshot.u.push(username);
+      snapshot.r.push(entry.tuple);
+      snapshot.f.push(entry.frequency || 1);
+      snapshot.a.push(Math.max(0, Math.round((savedAt - (entry.timestamp || savedAt)) / 1000)));
+    }
+    return payload;
+  },
+
+  // With a username only its shard is rewritten; without one just the meta (current user)
+  markDirty(username = null) {
+    if (username) this.dirtyShards.add(rankCacheShardFor(username));
+    else this.metaDirty = true;
+    this.scheduleWrite();
+  },
+
+  markAllDirty() {
+    for (let shard = 0; shard < RANK_CACHE_SHARD_COUNT; shard++) this.dirtyShards.add(shard);
+    this.metaDirty = true;
+    this.scheduleWrite();
+  },
+
+  scheduleWrite() {
+    const now = Date.now();
+    if (!this.firstDirtyAt) this.firstDirtyAt = now;
+
+    if (this.idleTimer) clearTimeout(this.idleTimer);
+    const delay = Math.min(RANK_CACHE_FLUSH_IDLE_MS, Math.max(0, this.firstDirtyAt + RANK_CACHE_FLUSH_MAX_DELAY_MS - now));
+    this.idleTimer = setTimeout(() => {
+      this.write().catch(() => {});
+    }, delay);
+  },
+
+  async write() {
+    if (this.idleTimer) {
+      clearTimeout(this.idleTimer);
+      this.idleTimer = null;
+    }
+    this.firstDirtyAt = 0;
+
+    if (this.writing) await this.writing;
+    if (this.dirtyShards.size === 0 && !this.metaDirty) return;
+    const shards = this.dirtyShards;
+    const metaDirty = this.metaDirty;
+    this.dirtyShards = new Set();
+    this.metaDirty = false;
+
+    const payload = this.encode(shards);
+    if (metaDirty) payload[RANK_SNAPSHOT_META_KEY] = { v: RANK_SNAPSHOT_VERSION, currentUser: userRankCache.currentUser };
+
+    this.writing = this.area().set(payload)
+      .catch(() => {
+        // Retry these shards on the next write rather than dropping them
+        for (const shard of shards) this.dirtyShards.add(shard);
+        if (metaDirty) this.metaDirty = true;
+      })
+      .finally(() => {
+        this.writing = null;
+      });
+    await this.writing;
+  },
+
+  async restore() {
+    const startedAt = Date.now();
+    let restored = 0;
+    try {
+      const data = await this.area().get([RANK_SNAPSHOT_META_KEY, RANK_SNAPSHOT_STORAGE_KEY, ...RANK_SNAPSHOT_SHARD_KEYS]);
+      if (data?.[RANK_SNAPSHOT_STORAGE_KEY]) this.area().remove(RANK_SNAPSHOT_STORAGE_KEY).catch(() => {});
+
+      const meta = data?.[RANK_SNAPSHOT_META_KEY];
+      if (meta?.v === RANK_SNAPSHOT_VERSION && meta.currentUser && !userRankCache.currentUser) {
+        userRankCache.setCurrentUser(meta.currentUser);
+      }
+      const sizeBefore = userRankCache.size;
+      for (const key of RANK_SNAPSHOT_SHARD_KEYS) {
+        const snapshot = data?.[key];
+        if (!snapshot || snapshot.v !== RANK_SNAPSHOT_VERSION || !Array.isArray(snapshot.u)) continue;
+        for (let i = 0; i < snapshot.u.length; i++) {
+          const timestamp = snapshot.savedAt - (snapshot.a[i] || 0) * 1000;
+          userRankCache.restore(snapshot.u[i], rankDataFromTuple(snapshot.r[i]), snapshot.f[i] || 1, timestamp);
+        }
+      }
+      restored = userRankCache.size - sizeBefore;
+    } catch (_) {}
+    return { restored, restoreMs: Date.now() - startedAt };
+  }
+};
+
+/**
+ * warmStart - gates message handling on the snapshot restore and measures how long a
+ * wake takes to serve its first rank (the point a tab can paint its first badge)
+ */
+const warmStart = {
+  startedAt: Date.now(),
+  isReady: false,
+  ready: null,
+  source: 'cold',
+  restoredEntries: 0,
+  restoreMs: 0,
+  firstBadgeMs: null,
+  firstBadgeFromCache: false,
+
+  begin() {
+    this.ready = rankCacheSnapshot.restore().then(({ restored, restoreMs }) => {
+      this.isReady = true;
+      this.restoredEntries = restored;
+      this.restoreMs = restoreMs;
+      this.source = restored > 0 ? 'snapshot' : 'cold';
+      if (restored > 0) {
+        console.log(`[EloWard Background] Warm start: restored ${restored} cached ranks in ${restoreMs}ms`);
+      }
+    });
+    return this.ready;
+  },
+
+  noteRankServed(fromCache) {
+    if (this.firstBadgeMs !== null) return;
+    this.firstBadgeMs = Date.now() - this.startedAt;
+    this.firstBadgeFromCache = !!fromCache;
+    console.log(`[EloWard Background] First rank served ${this.firstBadgeMs}ms after ${this.source} start (${fromCache ? 'cache' : 'api'})`);
+    this.recordSample();
+  },
+
+  async recordSample() {
+    const sample = {
+      at: Date.now(),
+      source: this.source,
+      restoredEntries: this.restoredEntries,
+      restoreMs: this.restoreMs,
+      firstBadgeMs: this.firstBadgeMs,
+      fromCache: this.firstBadgeFromCache
+    };
+    try {
+      const area = rankCacheSnapshot.area();
+      const data = await area.get([WARM_START_SAMPLES_KEY]);
+      const samples = Array.isArray(data?.[WARM_START_SAMPLES_KEY]) ? data[WARM_START_SAMPLES_KEY] : [];
+      samples.push(sample);
+      await area.set({ [WARM_START_SAMPLES_KEY]: samples.slice(-WARM_START_SAMPLE_LIMIT) });
+    } catch (_) {}
+  },
+
+  async metrics() {
+    let samples = [];
+    try {
+      const data = await rankCacheSnapshot.area().get([WARM_START_SAMPLES_KEY]);
+      if (Array.isArray(data?.[WARM_START_SAMPLES_KEY])) samples = data[WARM_START_SAMPLES_KEY];
+    } catch (_) {}
+    return {
+      current: {
+        source: this.source,
+        restoredEntries: this.restoredEntries,
+        restoreMs: this.restoreMs,
+        firstBadgeMs: this.firstBadgeMs,
+        fromCache: this.firstBadgeFromCache
+      },
+      samples
+    };
+  }
+};
+
+function notifyRankCacheChange(username) {
+  rankCacheSnapshot.markDirty(username);
+  rankCacheSync.noteChange(username);
+}
+
+// Staleness is not persisted (it is recomputed from timestamps), so only tab mirrors need to hear about it
+function notifyRankCacheStale(rule) {
+  rankCacheSync.noteStale(rule);
+}
+
+function notifyRankCacheReset() {
+  rankCacheSnapshot.markAllDirty();
+  rankCacheSync.noteReset();
+}
+
+browser.runtime.onConnect.addListener((port) => {
+  if (port.name !== RANK_CACHE_PORT_NAME) return;
+  // Hold the first snapshot until the warm-start restore has repopulated the cache
+  if (warmStart.isReady) {
+    rankCacheSync.connect(port);
+  } else {
+    warmStart.ready.then(() => rankCacheSync.connect(port));
+  }
+});
+
+const userRankCache = new UserRankCache();
+warmStart.begin();
+
+// Stale entries keep serving while a refresh goes through the shared lookup/batch pipeline
+userRankCache.onStale = (username) => {
+  lookupRankForUsername(username).catch(() => {});
+};
+
+/**
+ * RankLookupBatcher - coalesces rank lookups into multi-user requests
+ * Usernames queue for a short window (or until the batch fills), are resolved by one
+ * request to the rank worker, and the results fan back out to every waiting caller.
+ */
+class RankLookupBatcher {
+  constructor(windowMs = RANK_BATCH_WINDOW_MS, maxSize = RANK_BATCH_MAX_SIZE) {
+    this.windowMs = windowMs;
+    this.maxSize = maxSize;
+    this.queue = new Map(); // normalized username -> array of resolvers
+    this.flushTimer = null;
+    // Flipped off for the session if the worker does not expose the batch endpoint
+    this.batchEndpointAvailable = true;
+    // After a failed request, queued lookups are answered from the cache until this time
+    this.backoffUntil = 0;
+  }
+
+  enqueue(username) {
+    const normalizedUsername = username.toLowerCase();
+
+    return new Promise((resolve) => {
+      const waiters = this.queue.get(normalizedUsername);
+      if (waiters) {
+        waiters.push(resolve);
+      } else {
+        this.queue.set(normalizedUsername, [resolve]);
+      }
+
+      if (this.queue.size >= this.maxSize) {
+        this.flush();
+      } else if (!this.flushTimer) {
+        this.flushTimer = setTimeout(() => this.flush(), this.windowMs);
+      }
+    });
+  }
+
+  flush() {
+    if (this.flushTimer) {
+      clearTimeout(this.flushTimer);
+      this.flushTimer = null;
+    }
+    if (this.queue.size === 0) return;
+
+    const batch = this.queue;
+    this.queue = new Map();
+
+    const lookup = Date.now() < this.backoffUntil
+      ? Promise.resolve({})
+      : this.resolveBatch(Array.from(batch.keys())).catch(() => {
+        this.backoffUntil = Date.now() + RANK_CACHE_REVALIDATE_RETRY_MS;
+        return {};
+      });
+
+    lookup.then((ranksByUsername) => {
+      // Cache positive and negative results in a single pass. Users missing from the result
+      // failed transiently: their existing (possibly stale) entry stays as it is and is retried
+      userRankCache.setMany(ranksByUsername);
+
+      for (const [username, waiters] of batch.entries()) {
+        let rankData = ranksByUsername[username];
+        if (rankData === undefined) {
+          const cached = userRankCache.peek(username);
+          rankData = cached && cached !== NO_RANK_MARKER ? cached : null;
+        }
+        waiters.forEach(resolve => resolve(rankData || null));
+      }
+    });
+  }
+
+  // Throws when the worker is failing; per-user lookups are only a fallback for a missing batch route
+  async resolveBatch(usernames) {
+    if (this.batchEndpointAvailable) {
+      try {
+        return await fetchRanksFromDatabaseBatch(usernames);
+      } catch (error) {
+        if (error?.status !== 404 && error?.status !== 405) throw error;
+        this.batchEndpointAvailable = false;
+      }
+    }
+
+    const results = await Promise.allSettled(usernames.map(fetchRankFromDatabase));
+    const ranksByUsername = {};
+    usernames.forEach((username, index) => {
+      if (results[index].status === 'fulfilled') ranksByUsername[username] = results[index].value;
+    });
+    if (usernames.length > 0 && Object.keys(ranksByUsername).length === 0) {
+      throw new Error('Rank lookups failed');
+    }
+    return ranksByUsername;
+  }
+}
+
+const rankLookupBatcher = new RankLookupBatcher();
+
+// In-flight rank lookups keyed by normalized username, shared by every tab and message
+const pendingRankLookups = new Map();
+
+function lookupRankForUsername(username) {
+  const normalizedUsername = username.toLowerCase();
+
+  const pendingLookup = pendingRankLookups.get(normalizedUsername);
+  if (pendingLookup) {
+    return pendingLookup;
+  }
+
+  const lookup = fetchRankByTwitchUsername(normalizedUsername)
+    .finally(() => {
+      pendingRankLookups.delete(normalizedUsername);
+    });
+
+  pendingRankLookups.set(normalizedUsername, lookup);
+  return lookup;
+}
+/**
+ * viewerQualificationUploader - single sender for viewer qualifications from every tab
+ * Qualifications are deduped by (channel, stat_date), kept in a durable outbox in
+ * storage.local and uploaded in batches; failures are retried with exponential backoff
+ * and the outbox is resumed whenever the service worker wakes. Every scheduled flush also
+ * arms VIEWER_UPLOAD_ALARM, so a retry still runs when the worker is stopped before its timer.
+ */
+const viewerQualificationUploader = {
+  state: null, // { pending: { key: { payload, attempts, nextAttemptAt, queuedAt } }, sent: { key: sentAt } }
+  loading: null,
+  flushTimer: null,
+  flushAt: 0,
+  flushing: null,
+  batchEndpointAvailable: true,
+
+  keyFor(payload) {
+    return `${payload.channel_twitch_id}_${payload.stat_date}`;
+  },
+
+  load() {
+    if (this.state) return Promise.resolve(this.state);
+    if (!this.loading) {
+      this.loading = browser.storage.local.get([VIEWER_OUTBOX_STORAGE_KEY])
+        .then((data) => data?.[VIEWER_OUTBOX_STORAGE_KEY])
+        .catch(() => null)
+        .then((stored) => {
+          this.state = {
+            pending: stored?.pending || {},
+            sent: stored?.sent || {}
+          };
+          this.prune();
+          return this.state;
+        });
+    }
+    return this.loading;
+  },
+
+  async save() {
+    try {
+      await browser.storage.local.set({ [VIEWER_OUTBOX_STORAGE_KEY]: this.state });
+    } catch (_) {}
+  },
+
+  // The backend only accepts the current and previous window, so anything older can go
+  prune() {
+    const cutoff = Date.now() - VIEWER_OUTBOX_RETENTION_MS;
+    for (const [key, sentAt] of Object.entries(this.state.sent)) {
+      if (sentAt < cutoff) delete this.state.sent[key];
+    }
+    for (const [key, entry] of Object.entries(this.state.pending)) {
+      if ((entry.queuedAt || 0) < cutoff) delete this.state.pending[key];
+    }
+  },
+
+  async enqueue(payload) {
+    const normalized = {
+      stat_date: String(payload.stat_date),
+      channel_twitch_id: String(payload.channel_twitch_id).toLowerCase(),
+      riot_puuid: String(payload.riot_puuid)
+    };
+    const key = this.keyFor(normalized);
+    const state = await this.load();
+
+    if (state.sent[key]) {
+      return { queued: false, alreadySent: true };
+    }
+    if (!state.pending[key]) {
+      state.pending[key] = { payload: normalized, attempts: 0, nextAttemptAt: 0, queuedAt: Date.now() };
+      await this.save();
+    }
+    this.schedule(VIEWER_UPLOAD_BATCH_WINDOW_MS);
+    return { queued: true, alreadySent: false };
+  },
+
+  async resume() {
+    const state = await this.load();
+    if (Object.keys(state.pending).length > 0) {
+      this.schedule(0);
+    }
+  },
+
+  schedule(delayMs) {
+    const flushAt = Date.now() + delayMs;
+    if (this.flushTimer && this.flushAt <= flushAt) return;
+    if (this.flushTimer) clearTimeout(this.flushTimer);
+    this.flushAt = flushAt;
+    this.flushTimer = setTimeout(() => {
+      this.flushTimer = null;
+      this.flush();
+    }, delayMs);
+    if (delayMs > 0) browser.alarms.create(VIEWER_UPLOAD_ALARM, { when: flushAt });
+  },
+
+  flush() {
+    if (!this.flushing) {
+      this.flushing = this.runFlush().finally(() => {
+        this.flushing = null;
+      });
+    }
+    return this.flushing;
+  },
+
+  async runFlush() {
+    const state = await this.load();
+    const now = Date.now();
+    const due = Object.entries(state.pending)
+      .filter(([, entry]) => entry.nextAttemptAt <= now)
+      .slice(0, VIEWER_UPLOAD_BATCH_MAX_SIZE);
+
+    if (due.length > 0) {
+      const outcome = await this.upload(due.map(([key, entry]) => [key, entry.payload]));
+
+      for (const [key, entry] of due) {
+        if (outcome.accepted.has(key)) {
+          state.sent[key] = Date.now();
+          delete state.pending[key];
+        } else if (outcome.rejected.has(key)) {
+          // Validation failures will not succeed on retry
+          delete state.pending[key];
+        } else {
+          entry.attempts += 1;
+          const backoff = Math.min(VIEWER_UPLOAD_RETRY_BASE_MS * 2 ** (entry.attempts - 1), VIEWER_UPLOAD_RETRY_MAX_MS);
+          entry.nextAttemptAt = Date.now() + backoff * (0.75 + Math.random() * 0.5);
+        }
+      }
+
+      this.prune();
+      await this.save();
+
+      if (outcome.accepted.size > 0) {
+        console.log(`[EloWard Viewer] ✅ Uploaded ${outcome.accepted.size} qualification(s)`);
+      }
+    }
+
+    const remaining = Object.values(state.pending);
+    if (remaining.length > 0) {
+      const nextAttemptAt = Math.min(...remaining.map(entry => entry.nextAttemptAt));
+      this.schedule(Math.max(0, nextAttemptAt - Date.now()));
+    } else {
+      browser.alarms.clear(VIEWER_UPLOAD_ALARM).catch(() => {});
+    }
+  },
+
+  async upload(items) {
+    const accepted = new Set();
+    const rejected = new Set();
+
+    if (this.batchEndpointAvailable && items.length > 1) {
+      try {
+        const response = await fetch(`${VIEWER_BACKEND_URL}/view/qualify/batch`, {
+          method: 'POST',
+          headers: { 'Content-Type': 'application/json' },
+          body: JSON.stringify({ qualifications: items.map(([, payload]) => payload) })
+        });
+        if (response.ok) {
+          items.forEach(([key]) => accepted.add(key));
+          return { accepted, rejected };
+        }
+        if (response.status >= 500 || response.status === 429) {
+          return { accepted, rejected };
+        }
+        if (response.status === 404 || response.status === 405) {
+          this.batchEndpointAvailable = false;
+        }
+        // Other 4xx: let the per-item path work out which entries are invalid
+      } catch (_) {
+        return { accepted, rejected };
+      }
+    }
+
+    // Per-item fallback keeps working against a backend without the batch route
+    await Promise.all(items.map(async ([key, payload]) => {
+      try {
+        const response = await fetch(`${VIEWER_BACKEND_URL}/view/qualify`, {
+          method: 'POST',
+          headers: { 'Content-Type': 'application/json' },
+          body: JSON.stringify(payload)
+        });
+        if (response.ok) {
+          accepted.add(key);
+        } else if (response.status >= 400 && response.status < 500 && response.status !== 429) {
+          rejected.add(key);
+          console.error(`[EloWard Viewer] ❌ Qualification rejected for ${payload.channel_twitch_id}:`, response.status);
+        }
+      } catch (_) {}
+    }));
+
+    return { accepted, rejected };
+  }
+};
+
+viewerQualificationUploader.resume();
+
+/**
+ * channelRankPrefetcher - warms userRankCache with a channel's regular EloWard viewers on entry
+ * Only positive rows are loaded (absent users are not known to be unranked), each channel is
+ * fetched at most once per CHANNEL_PREFETCH_COOLDOWN_MS, and concurrent tabs share one request.
+ */
+const channelRankPrefetcher = {
+  lastPrefetchAt: new Map(), // channel -> ms
+  members: new Map(), // channel -> Set of usernames from its last prefetch, for tab snapshots and deltas
+  inFlight: new Map(), // channel -> Promise<number>
+  endpointAvailable: true, // Flipped off for the session if the worker lacks the route
+
+  prefetch(channel) {
+    const normalizedChannel = String(channel || '').toLowerCase();
+    if (!normalizedChannel || !this.endpointAvailable) return Promise.resolve(0);
+
+    const pending = this.inFlight.get(normalizedChannel);
+    if (pending) return pending;
+
+    const lastPrefetchAt = this.lastPrefetchAt.get(normalizedChannel) || 0;
+    if (Date.now() - lastPrefetchAt < CHANNEL_PREFETCH_COOLDOWN_MS) return Promise.resolve(0);
+    this.lastPrefetchAt.set(normalizedChannel, Date.now());
+
+    const request = fetchChannelRanks(normalizedChannel)
+      .then((ranksByUsername) => {
+        this.members.set(normalizedChannel, new Set(Object.keys(ranksByUsername)));
+        // Leave fresh entries (and the current user's linked data) as they are
+        const toLoad = {};
+        for (const [username, rankData] of Object.entries(ranksByUsername)) {
+          if (username === userRankCache.currentUser) continue;
+          if (userRankCache.peek(username) && userRankCache.staleAtFor(username) > Date.now()) continue;
+          toLoad[username] = rankData;
+        }
+        userRankCache.setMany(toLoad);
+        return Object.keys(toLoad).length;
+      })
+      .catch((error) => {
+        if (error?.status === 404 || error?.status === 405) {
+          this.endpointAvailable = false;
+        } else {
+          // Transient failure: allow the next channel entry to try again
+          this.lastPrefetchAt.delete(normalizedChannel);
+        }
+        return 0;
+      })
+      .finally(() => {
+        this.inFlight.delete(normalizedChannel);
+      });
+
+    this.inFlight.set(normalizedChannel, request);
+    return request;
+  },
+
+  membersOf(channel) {
+    return (channel && this.members.get(String(channel).toLowerCase())) || new Set();
+  }
+};
+
+/**
+ * tabRegistry - tracks every Twitch tab so shared work runs once instead of per tab
+ * The earliest-registered tab is the leader (page-side storage maintenance) and the
+ * earliest tab on each channel owns that channel's viewer tracking.
+ * Roles are pushed to tabs as 'eloward_tab_role' whenever they change. State lives in the
+ * warm-start storage area so a restarted service worker keeps the same leader.
+ */
+const tabRegistry = {
+  state: null, // { tabs: { [tabId]: { channel, registeredAt } } }
+  loading: null,
+
+  load() {
+    if (this.state) return Promise.resolve(this.state);
+    if (!this.loading) {
+      this.loading = (async () => {
+        let stored = null;
+        try {
+          const data = await rankCacheSnapshot.area().get([TAB_REGISTRY_STORAGE_KEY]);
+          stored = data?.[TAB_REGISTRY_STORAGE_KEY];
+        } catch (_) {}
+        const tabs = stored?.tabs || {};
+
+        // Drop tabs that closed while nothing was listening
+        try {
+          const openTabIds = new Set((await browser.tabs.query({})).map(tab => String(tab.id)));
+          for (const tabId of Object.keys(tabs)) {
+            if (!openTabIds.has(tabId)) delete tabs[tabId];
+          }
+        } catch (_) {}
+
+        this.state = { tabs };
+        return this.state;
+      })();
+    }
+    return this.loading;
+  },
+
+  async save() {
+    try {
+      await rankCacheSnapshot.area().set({ [TAB_REGISTRY_STORAGE_KEY]: this.state });
+    } catch (_) {}
+  },
+
+  rolesFor(tabId) {
+    const tabs = this.state.tabs;
+    const entry = tabs[tabId];
+    if (!entry) return { leader: false, channelOwner: false };
+
+    let leaderId = null;
+    let ownerId = null;
+    for (const [id, tab] of Object.entries(tabs)) {
+      if (leaderId === null || tab.registeredAt < tabs[leaderId].registeredAt) leaderId = id;
+      if (entry.channel && tab.channel === entry.channel &&
+          (ownerId === null || tab.registeredAt < tabs[ownerId].registeredAt)) ownerId = id;
+    }
+    return { leader: leaderId === String(tabId), channelOwner: !!entry.channel && ownerId === String(tabId) };
+  },
+
+  // Recompute roles after a change and push them to any tab whose role moved
+  async updateAndNotify(mutate, skipTabId = null) {
+    const state = await this.load();
+    const before = {};
+    for (const tabId of Object.keys(state.tabs)) before[tabId] = this.rolesFor(tabId);
+
+    mutate(state);
+    await this.save();
+
+    for (const tabId of Object.keys(state.tabs)) {
+      if (tabId === String(skipTabId)) continue;
+      const roles = this.rolesFor(tabId);
+      const previous = before[tabId];
+      if (!previous || previous.leader !== roles.leader || previous.channelOwner !== roles.channelOwner) {
+        browser.tabs.sendMessage(Number(tabId), { type: 'eloward_tab_role', ...roles }).catch(() => {});
+      }
+    }
+  },
+
+  async register(tabId, channel) {
+    const key = String(tabId);
+    const normalizedChannel = channel ? String(channel).toLowerCase() : null;
+    await this.updateAndNotify((state) => {
+      const existing = state.tabs[key];
+      state.tabs[key] = {
+        channel: normalizedChannel,
+        registeredAt: existing ? existing.registeredAt : Date.now()
+      };
+    }, tabId);
+    return this.rolesFor(key);
+  },
+
+  async remove(tabId) {
+    const state = await this.load();
+    if (!state.tabs[String(tabId)]) return;
+    await this.updateAndNotify((mutableState) => {
+      delete mutableState.tabs[String(tabId)];
+    });
+  }
+};
+
+browser.tabs.onRemoved.addListener((tabId) => {
+  tabRegistry.remove(tabId).catch(() => {});
+});
+
+/**
+ * badgeAssetStore - rank badge images kept in the extension origin's Cache Storage
+ * A content script's caches belong to twitch.tv, so the store lives here and tabs ask for each
+ * badge with 'get_badge_asset'. Bytes go back as a data URL (runtime messages can't carry
+ * Blobs) and the tab turns them into a blob: URL. Lookup order: the per-tier store, then the
+ * badge pack once it has loaded, then the CDN. The pack is one manifest plus one bundle of
+ * every tier/variant; its assets are stored by SHA-256 so a new pack only downloads what
+ * changed. Being the only writer, the background also does the cleanup for every tab.
+ */
+const badgeAssetStore = {
+  packs: new Map(), // version -> { index: { [key]: hash } | null, loading, retryAt }
+  cleanedUp: false,
+
+  open(name) {
+    if (typeof caches === 'undefined') return Promise.resolve(null);
+    return caches.open(name).catch(() => null);
+  },
+
+  packAssetUrl(hash) {
+    return `${BADGE_CDN_BASE}/lol/badges/asset/${hash}`;
+  },
+
+  async sha256Hex(buffer) {
+    const digest = await crypto.subtle.digest('SHA-256', buffer);
+    return Array.from(new Uint8Array(digest), byte => byte.toString(16).padStart(2, '0')).join('');
+  },
+
+  async toDataUrl(response) {
+    const type = response.headers.get('Content-Type') || 'image/png';
+    const bytes = new Uint8Array(await response.arrayBuffer());
+    let binary = '';
+    for (let i = 0; i < bytes.length; i += 0x8000) {
+      binary += String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000));
+    }
+    return `data:${type};base64,${btoa(binary)}`;
+  },
+
+  // Fetch only the byte ranges for missing assets; servers that ignore Range send the whole bundle
+  async fetchPackAssets(bundleUrl, missing) {
+    const start = Math.min(...missing.map(([, asset]) => asset.offset));
+    const end = Math.max(...missing.map(([, asset]) => asset.offset + asset.length)) - 1;
+    const resp = await fetch(bundleUrl, {
+      mode: 'cors',
+      cache: 'default',
+      credentials: 'omit',
+      headers: { Range: `bytes=${start}-${end}` }
+    });
+    if (!resp.ok) throw new Error(String(resp.status));
+    const buffer = await resp.arrayBuffer();
+    const base = resp.status === 206 ? start : 0;
+
+    const buffers = new Map();
+    for (const [key, asset] of missing) {
+      buffers.set(key, buffer.slice(asset.offset - base, asset.offset - base + asset.length));
+    }
+    return buffers;
+  },
 
-    if (entry) {
-      if (entry.timestamp && (Date.now() - entry.timestamp > RANK_CACHE_EXPIRY)) {
-        this.cache.delete(normalizedUsername);
-        return null;
-      }
+  // Resolves with { key: hash } for the assets now stored, or null without a pack
+  async loadPack(version) {
+    if (typeof caches === 'undefined' || !crypto?.subtle) return null;
 
-      entry.frequency = (entry.frequency || 0) + 1;
-      
-      // Return the rank data, which could be actual rank data or NO_RANK_MARKER
-      return entry.rankData;
+    // A 404 is remembered for the session, across service worker restarts
+    try {
+      const data = await rankCacheSnapshot.area().get([BADGE_PACK_STATE_KEY]);
+      const notFound = data?.[BADGE_PACK_STATE_KEY];
+      if (notFound?.version === version && Date.now() - notFound.at < BADGE_PACK_MISSING_TTL_MS) return null;
+    } catch (_) {}
+
+    // The manifest URL is versioned, so the HTTP cache can answer it
+    const manifestResp = await fetch(`${BADGE_CDN_BASE}/lol/badges/manifest.json?v=${version}`, {
+      mode: 'cors', cache: 'default', credentials: 'omit'
+    });
+    if (manifestResp.status === 404) {
+      rankCacheSnapshot.area().set({ [BADGE_PACK_STATE_KEY]: { version, at: Date.now() } }).catch(() => {});
+      return null;
+    }
+    if (!manifestResp.ok) throw new Error(String(manifestResp.status));
+    const manifest = await manifestResp.json();
+    const assets = Object.entries(manifest?.assets || {});
+    if (!manifest.bundle || assets.length === 0) return null;
+
+    const store = await this.open(BADGE_PACK_STORE_NAME);
+    if (!store) return null;
+    const index = {};
+    const missing = [];
+    for (const [key, asset] of assets) {
+      if (await store.match(this.packAssetUrl(asset.hash))) index[key] = asset.hash;
+      else missing.push([key, asset]);
     }
 
-    return null;
-  }
+    if (missing.length > 0) {
+      const bundleUrl = new URL(manifest.bundle, `${BADGE_CDN_BASE}/`).href;
+      const buffers = await this.fetchPackAssets(bundleUrl, missing);
+      for (const [key, asset] of missing) {
+        const buffer = buffers.get(key);
+        // Skip anything that doesn't match its hash; per-tier fetches cover it
+        if (!buffer || await this.sha256Hex(buffer) !== asset.hash) continue;
+        const type = asset.type || 'image/png';
+        await store.put(this.packAssetUrl(asset.hash), new Response(buffer, { headers: { 'Content-Type': type } }));
+        index[key] = asset.hash;
+      }
+    }
 
+    // Drop assets the current manifest no longer references
+    const liveUrls = new Set(assets.map(([, asset]) => this.packAssetUrl(asset.hash)));
+    for (const request of await store.keys()) {
+      if (!liveUrls.has(request.url)) store.delete(request).catch(() => {});
+    }
+    return index;
+  },
+
+  // Starts the pack load without waiting on it; a failed load is retried after BADGE_PACK_RETRY_MS
+  ensurePack(version) {
+    let pack = this.packs.get(version);
+    if (pack && (pack.loading || pack.index || Date.now() < pack.retryAt)) return pack;
+    pack = { index: null, loading: null, retryAt: 0 };
+    this.packs.set(version, pack);
+    pack.loading = this.loadPack(version)
+      .then((index) => {
+        pack.index = index;
+        // No pack published: nothing to retry this session
+        if (!index) pack.retryAt = Infinity;
+      })
+      .catch(() => {
+        pack.retryAt = Date.now() + BADGE_PACK_RETRY_MS;
+      })
+      .finally(() => {
+        pack.loading = null;
+      });
+    return pack;
+  },
 
-  set(username, rankData) {
-    if (!username) return;
-    
-    // Allow caching of null/undefined results as negative cache entries
-    const dataToCache = rankData || NO_RANK_MARKER;
+  // Drop per-tier stores left behind by older badge versions
+  async cleanupOldStores(version) {
+    if (this.cleanedUp || typeof caches === 'undefined') return;
+    this.cleanedUp = true;
+    try {
+      const current = `${BADGE_STORE_PREFIX}v${version}`;
+      const names = await caches.keys();
+      await Promise.all(names
+        .filter(name => name.startsWith(BADGE_STORE_PREFIX) && name !== current)
+        .map(name => caches.delete(name)));
+    } catch (_) {}
+  },
 
-    const normalizedUsername = username.toLowerCase();
-    let entry = this.cache.get(normalizedUsername);
+  async get(key, url, version) {
+    const pack = this.ensurePack(version);
+    this.cleanupOldStores(version);
 
-    if (entry) {
-      entry.rankData = dataToCache;
-      entry.frequency = (entry.frequency || 0) + 1;
-      entry.timestamp = Date.now();
-    } else {
-      entry = { 
-        rankData: dataToCache, 
-        frequency: 1,
-        timestamp: Date.now()
-      };
-      this.cache.set(normalizedUsername, entry);
+    const store = await this.open(`${BADGE_STORE_PREFIX}v${version}`);
+    let response = store ? await store.match(url) : null;
 
-      if (this.cache.size > this.maxSize) {
-        this.evictLFU();
-      }
+    if (!response) {
+      // Use the pack's copy if it already arrived, otherwise fetch from CDN and keep a copy
+      const hash = pack.index?.[key];
+      const packStore = hash ? await this.open(BADGE_PACK_STORE_NAME) : null;
+      response = packStore ? await packStore.match(this.packAssetUrl(hash)) : null;
     }
-
-    maybePersistRankCache(this).catch(() => {});
+    if (!response) {
+      response = await fetch(url, { mode: 'cors', cache: 'default', credentials: 'omit' });
+      if (!response.ok) throw new Error(String(response.status));
+      if (store) store.put(url, response.clone()).catch(() => {}); // Non-blocking
+    }
+    return this.toDataUrl(response);
   }
+};
 
-  clear() {
-    const currentUserEntry = this.currentUser ? this.cache.get(this.currentUser) : null;
-    this.cache.clear();
+/**
+ * rankRefreshScheduler - keeps the local user's own rank current while they are chatting
+ * Tabs report when the local user's messages appear in chat. While that happened within
+ * RANK_REFRESH_ACTIVE_WINDOW_MS, one alarm refreshes through RiotAuth.refreshRank every
+ * RANK_REFRESH_INTERVAL_MS, backing off after failures; reports from any number of tabs share
+ * it. The new rank goes into userRankCache, which pushes it to every tab as a rank_cache_delta.
+ */
+const rankRefreshScheduler = {
+  state: null, // { lastActivityAt, failures, nextAttemptAt }
+  loading: null,
+  running: null,
+
+  load() {
+    if (this.state) return Promise.resolve(this.state);
+    if (!this.loading) {
+      this.loading = (async () => {
+        let stored = null;
+        try {
+          const data = await rankCacheSnapshot.area().get([RANK_REFRESH_STATE_KEY]);
+          stored = data?.[RANK_REFRESH_STATE_KEY];
+        } catch (_) {}
+        this.state = {
+          lastActivityAt: Number(stored?.lastActivityAt) || 0,
+          failures: Number(stored?.failures) || 0,
+          nextAttemptAt: Number(stored?.nextAttemptAt) || 0
+        };
+        return this.state;
+      })();
+    }
+    return this.loading;
+  },
 
-    // Preserve current user entry to prevent loss of local user data
-    if (this.currentUser && currentUserEntry) {
-      this.cache.set(this.currentUser, currentUserEntry);
+  async save() {
+    try {
+      await rankCacheSnapshot.area().set({ [RANK_REFRESH_STATE_KEY]: this.state });
+    } catch (_) {}
+  },
+
+  isActive(state) {
+    return Date.now() - state.lastActivityAt < RANK_REFRESH_ACTIVE_WINDOW_MS;
+  },
+
+  // The popup's manual refresh also writes eloward_last_rank_refresh_at, pushing this back
+  async dueAt(state) {
+    const { eloward_last_rank_refresh_at: lastRefreshAt } = await StorageMirror.get(['eloward_last_rank_refresh_at']);
+    const intervalDueAt = lastRefreshAt ? Number(lastRefreshAt) + RANK_REFRESH_INTERVAL_MS : 0;
+    return Math.max(intervalDueAt, state.nextAttemptAt);
+  },
+
+  async noteActivity() {
+    const state = await this.load();
+    state.lastActivityAt = Date.now();
+    await this.save();
+    await this.schedule();
+  },
+
+  async schedule() {
+    const state = await this.load();
+    if (!this.isActive(state)) {
+      await browser.alarms.clear(RANK_REFRESH_ALARM);
+      return;
     }
 
-    maybePersistRankCache(this).catch(() => {});
-  }
+    const dueAt = await this.dueAt(state);
+    if (dueAt <= Date.now()) {
+      this.run().catch(() => {});
+      return;
+    }
 
-  evictLFU() {
-    let lowestFrequency = Infinity;
-    let userToEvict = null;
+    const existing = await browser.alarms.get(RANK_REFRESH_ALARM);
+    if (existing && Math.abs(existing.scheduledTime - dueAt) < 1000) return;
+    browser.alarms.create(RANK_REFRESH_ALARM, { when: dueAt });
+  },
 
-    for (const [key, entry] of this.cache.entries()) {
-      // Never evict current user
-      if (key === this.currentUser) {
-        continue;
-      }
+  // A single refresh at a time, however many tabs or alarms ask for one
+  run() {
+    if (!this.running) {
+      this.running = this.refresh().finally(() => {
+        this.running = null;
+      });
+    }
+    return this.running;
+  },
 
-      if (entry.timestamp && (Date.now() - entry.timestamp > RANK_CACHE_EXPIRY)) {
-        this.cache.delete(key);
-        return;
-      }
+  async refresh() {
+    const state = await this.load();
+    if (!this.isActive(state) || await this.dueAt(state) > Date.now()) {
+      await this.schedule();
+      return;
+    }
 
-      if (entry.frequency < lowestFrequency) {
-        lowestFrequency = entry.frequency;
-        userToEvict = key;
-      }
+    const persistentRiotData = await PersistentStorage.getRiotUserData();
+    if (!persistentRiotData?.puuid) {
+      // Nothing to refresh until a Riot account is linked; the next chat activity checks again
+      await browser.alarms.clear(RANK_REFRESH_ALARM);
+      return;
     }
 
-    if (userToEvict) {
-      this.cache.delete(userToEvict);
+    try {
+      let authenticated = false;
+      try { authenticated = await RiotAuth.isAuthenticated(true); } catch (_) { authenticated = false; }
+      if (!authenticated) throw new Error('Riot account not authenticated');
+
+      await refreshLocalUserRank(persistentRiotData);
+      state.failures = 0;
+      state.nextAttemptAt = 0;
+      await StorageMirror.set({ eloward_last_rank_refresh_at: Date.now() });
+      console.log('[EloWard] Auto rank refresh completed');
+    } catch (e) {
+      // Refresh failures never touch stored data; retry with exponential backoff and jitter
+      state.failures += 1;
+      const backoff = Math.min(RANK_REFRESH_RETRY_BASE_MS * 2 ** (state.failures - 1), RANK_REFRESH_RETRY_MAX_MS);
+      state.nextAttemptAt = Date.now() + backoff * (0.75 + Math.random() * 0.5);
+      console.warn('[EloWard] Auto rank refresh failed:', e?.message || 'unknown error');
     }
 
-    // Persist after eviction to keep storage mirror in sync
-    maybePersistRankCache(this).catch(() => {});
+    await this.save();
+    await this.schedule();
   }
+};
 
-  has(username) {
-    if (!username) return false;
-    const normalizedUsername = username.toLowerCase();
+browser.alarms.onAlarm.addListener((alarm) => {
+  if (alarm.name === RANK_REFRESH_ALARM) rankRefreshScheduler.run().catch(() => {});
+  if (alarm.name === VIEWER_UPLOAD_ALARM) viewerQualificationUploader.resume().catch(() => {});
+});
 
-    const entry = this.cache.get(normalizedUsername);
-    if (entry && entry.timestamp && (Date.now() - entry.timestamp > RANK_CACHE_EXPIRY)) {
-      this.cache.delete(normalizedUsername);
-      return false;
-    }
+/**
+ * popupViewModel - everything the popup paints on open, derived from storage in one place
+ * Rebuilt (coalesced per task) whenever the stored accounts, rank, options or section state
+ * change, and pushed to an open popup as 'popup_view_model'. The popup keeps the last copy in
+ * its localStorage so its first frame needs no storage or network call at all.
+ */
+const popupViewModel = {
+  current: null,
+  building: null,
+  rebuildTimer: null,
+
+  async build() {
+    const data = await StorageMirror.get(POPUP_VIEW_MODEL_KEYS);
+    const twitchData = data.eloward_persistent_twitch_user_data;
+    const riotData = data.eloward_persistent_riot_user_data;
+    const userOptions = data.eloward_user_options || {};
+    const riotConnected = !!(riotData?.riotId && riotData?.puuid);
+    const solo = riotData?.soloQueueRank;
 
-    return this.cache.has(normalizedUsername);
+    return {
+      twitch: twitchData?.id ? { name: twitchData.display_name || twitchData.login } : null,
+      riot: riotConnected ? { riotId: riotData.riotId, region: riotData.region || null } : null,
+      rank: riotConnected && solo?.tier ? {
+        tier: solo.tier,
+        division: solo.division || null,
+        leaguePoints: solo.leaguePoints ?? null
+      } : null,
+      options: {
+        plus_active: !!riotData?.plus_active,
+        show_peak: !!(userOptions.show_peak ?? riotData?.show_peak),
+        animate_badge: !!(userOptions.animate_badge ?? riotData?.animate_badge)
+      },
+      selectedRegion: data.selectedRegion || null,
+      sections: {
+        accountCollapsed: data.accountSectionCollapsed === true,
+        optionsCollapsed: data.optionsSectionCollapsed === true
+      },
+      builtAt: Date.now()
+    };
+  },
+
+  get() {
+    if (this.current) return Promise.resolve(this.current);
+    if (!this.building) {
+      this.building = this.build()
+        .then((viewModel) => {
+          this.current = viewModel;
+          return viewModel;
+        })
+        .finally(() => {
+          this.building = null;
+        });
+    }
+    return this.building;
+  },
+
+  invalidate() {
+    this.current = null;
+    if (this.rebuildTimer) return;
+    this.rebuildTimer = setTimeout(() => {
+      this.rebuildTimer = null;
+      this.get()
+        .then((viewModel) => browser.runtime.sendMessage({ type: 'popup_view_model', viewModel }))
+        .catch(() => {}); // No popup open
+    }, 0);
   }
+};
 
-  get size() {
-    return this.cache.size;
+browser.storage.onChanged.addListener((changes, areaName) => {
+  if (areaName !== 'local') return;
+  if (POPUP_VIEW_MODEL_KEYS.some(key => key in changes)) popupViewModel.invalidate();
+});
+
+// Options first so the backend returns the right rank (current or peak) for the user's settings
+async function refreshLocalUserRank(persistentRiotData) {
+  const optionsData = await fetchOptionsDataByPuuid(persistentRiotData.puuid);
+  if (optionsData) {
+    await updateLocalOptionsData(optionsData);
   }
+
+  const refreshedRankData = await RiotAuth.refreshRank(persistentRiotData.puuid);
+
+  const updatedUserData = {
+    ...persistentRiotData,
+    soloQueueRank: {
+      tier: refreshedRankData.rank_tier,
+      division: refreshedRankData.rank_division,
+      leaguePoints: refreshedRankData.lp
+    },
+    plus_active: optionsData.plus_active ? 1 : 0,
+    show_peak: optionsData.show_peak,
+    animate_badge: optionsData.animate_badge
+  };
+
+  await PersistentStorage.storeRiotUserData(updatedUserData);
+
+  // The cache entry reaches every open chat through rankCacheSync
+  const twitchData = await PersistentStorage.getTwitchUserData();
+  const twitchUsername = twitchData?.login?.toLowerCase();
+  if (!twitchUsername) return;
+
+  const solo = updatedUserData.soloQueueRank;
+  userRankCache.set(twitchUsername, {
+    tier: solo.tier,
+    division: solo.division,
+    leaguePoints: solo.leaguePoints,
+    summonerName: updatedUserData.riotId,
+    region: refreshedRankData.region,
+    animate_badge: optionsData.animate_badge
+  });
 }
 
-const userRankCache = new UserRankCache();
 let authWindows = {};
 const processedAuthStates = new Set();
 
@@ -241,7 +2099,7 @@ async function initiateTokenExchange(authData, service = 'riot') {
       // Get region that was stored before auth window opened
       let region = 'na1';
       try {
-        const data = await browser.storage.local.get(['selectedRegion']);
+        const data = await StorageMirror.get(['selectedRegion']);
         if (data && data.selectedRegion) region = data.selectedRegion;
       } catch (_) {}
 
@@ -279,64 +2137,62 @@ console.log('[EloWard Background] Setting up message listeners...');
   } catch (_) {}
 })();
 
-// Persist/restore helpers for the rank cache (optional, gated by persistence flag)
-async function maybePersistRankCache(cacheInstance) {
-  try {
-    const { eloward_data_persistence_enabled: persistenceEnabled } = await browser.storage.local.get(['eloward_data_persistence_enabled']);
-    if (!persistenceEnabled) return;
+// MV3 injects through the scripting API; Firefox MV2 falls back to tabs.executeScript, one file at a time
+async function injectChatEngine(tabId, frameId) {
+  if (browser.scripting && browser.scripting.executeScript) {
+    await browser.scripting.executeScript({ target: { tabId, frameIds: [frameId] }, files: CHAT_ENGINE_FILES });
+    return;
+  }
+  for (const file of CHAT_ENGINE_FILES) {
+    await browser.tabs.executeScript(tabId, { file: `/${file}`, frameId });
+  }
+}
 
-    const payload = {};
-    for (const [username, entry] of cacheInstance.cache.entries()) {
-      // Handle both positive and negative cache entries
-      let rankData = entry.rankData;
-      
-      // Convert NO_RANK_MARKER to serializable form for storage
-      if (rankData === NO_RANK_MARKER) {
-        rankData = { __noRank: true, __cacheType: 'negative' };
-      }
-      
-      payload[username] = {
-        rankData: rankData,
-        frequency: entry.frequency || 0,
-        timestamp: entry.timestamp || Date.now()
-      };
+// Background metrics plus, optionally, each registered Twitch tab's own snapshot (for the popup export)
+async function collectMetrics(includeTabs) {
+  const metrics = {
+    collectedAt: Date.now(),
+    background: EloWardMetrics.snapshot(),
+    cache: { size: userRankCache.cache.size, maxSize: userRankCache.maxSize },
+    tabs: []
+  };
+  if (!includeTabs) return metrics;
+
+  const state = await tabRegistry.load();
+  metrics.tabs = (await Promise.all(Object.keys(state.tabs).map(async (tabId) => {
+    try {
+      const response = await browser.tabs.sendMessage(Number(tabId), { type: 'eloward_get_metrics' });
+      return response?.metrics ? { tabId: Number(tabId), channel: response.channel, ...response.metrics } : null;
+    } catch (_) {
+      return null;
     }
-    await browser.storage.local.set({
-      [RANK_CACHE_STORAGE_KEY]: payload,
-      [RANK_CACHE_UPDATED_AT_KEY]: Date.now()
-    });
-  } catch (_) { /* ignore */ }
+  }))).filter(Boolean);
+  return metrics;
 }
 
-async function restoreRankCacheFromStorage(cacheInstance) {
-  try {
-    const { eloward_data_persistence_enabled: persistenceEnabled } = await browser.storage.local.get(['eloward_data_persistence_enabled']);
-    if (!persistenceEnabled) return;
+browser.runtime.onMessage.addListener(function handleRuntimeMessage(message, sender, sendResponse) {
+  // Rank cache actions wait for the warm-start restore, so the first chat burst after a wake hits
+  // the cache; everything else (including messages no handler answers) goes straight through
+  if (!warmStart.isReady && RANK_CACHE_ACTIONS.has(message?.action)) {
+    warmStart.ready.then(() => handleRuntimeMessage(message, sender, sendResponse));
+    return true;
+  }
 
-    const data = await browser.storage.local.get([RANK_CACHE_STORAGE_KEY]);
-    const stored = data[RANK_CACHE_STORAGE_KEY];
-    if (!stored || typeof stored !== 'object') return;
+  EloWardMetrics.count(`ipc.in.${message.action || message.type || 'unknown'}`);
 
-    for (const [username, entry] of Object.entries(stored)) {
-      if (entry) {
-        let rankData = entry.rankData;
-        
-        // Convert stored negative cache entries back to NO_RANK_MARKER
-        if (rankData && rankData.__noRank && rankData.__cacheType === 'negative') {
-          rankData = NO_RANK_MARKER;
-        }
-        
-        cacheInstance.cache.set(username.toLowerCase(), {
-          rankData: rankData,
-          frequency: entry.frequency || 1,
-          timestamp: entry.timestamp || Date.now()
-        });
-      }
-    }
-  } catch (_) { /* ignore */ }
-}
+  if (message.action === 'get_metrics') {
+    collectMetrics(message.includeTabs !== false)
+      .then(metrics => sendResponse({ success: true, metrics }))
+      .catch(error => sendResponse({ success: false, error: error.message }));
+    return true;
+  }
 
-browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
+  if (message.action === 'get_warm_start_metrics') {
+    warmStart.metrics()
+      .then(metrics => sendResponse({ success: true, metrics }))
+      .catch(error => sendResponse({ success: false, error: error.message }));
+    return true;
+  }
   
   if (message.action === 'increment_db_reads' && message.channel) {
     // METRICS DISABLED: Comment out backend metrics calls
@@ -542,6 +2398,7 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
         //   incrementSuccessfulLookupCounter(channelName).catch(() => {});
         // }
         
+        warmStart.noteRankServed(true);
         sendResponse({
           success: true,
           rankData: cachedRankData,
@@ -552,17 +2409,16 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
       }
     }
     
-    // Fetch rank data from database (region is already stored there)
-    fetchRankByTwitchUsername(username)
+    // Fetch rank data from database (region is already stored there); caching happens in the batcher.
+    // Concurrent requests for the same user share one lookup.
+    lookupRankForUsername(username)
       .then(rankData => {
-        // Cache both positive and negative results
-        userRankCache.set(username, rankData);
-        
         // METRICS DISABLED: Only increment successful lookups for backend hits with actual rank data
         // if (rankData && channelName && rankData?.tier) {
         //   incrementSuccessfulLookupCounter(channelName).catch(() => {});
         // }
         
+        if (rankData) warmStart.noteRankServed(false);
         sendResponse({ success: true, rankData, source: 'api' });
       })
       .catch(error => {
@@ -572,6 +2428,53 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
     return true;
   }
   
+  if (message.action === 'fetch_ranks_for_usernames') {
+    const usernames = Array.isArray(message.usernames) ? message.usernames.filter(Boolean) : [];
+    rankCacheSync.noteInterest(sender?.tab?.id, usernames);
+
+    if (usernames.length === 0) {
+      sendResponse({ success: false, error: 'No usernames provided' });
+      return true;
+    }
+
+    const ranks = {};
+    const lookups = [];
+    let servedFromCache = false;
+
+    for (const username of usernames) {
+      const normalizedUsername = username.toLowerCase();
+      const cachedRankData = userRankCache.get(normalizedUsername);
+
+      if (cachedRankData !== null) {
+        ranks[normalizedUsername] = cachedRankData === NO_RANK_MARKER ? null : cachedRankData;
+        if (cachedRankData !== NO_RANK_MARKER) servedFromCache = true;
+        continue;
+      }
+
+      lookups.push(
+        lookupRankForUsername(normalizedUsername).then(rankData => {
+          ranks[normalizedUsername] = rankData || null;
+        })
+      );
+    }
+
+    Promise.all(lookups)
+      .then(() => {
+        if (Object.values(ranks).some(Boolean)) warmStart.noteRankServed(servedFromCache);
+        sendResponse({ success: true, ranks });
+      })
+      .catch(error => sendResponse({ success: false, error: error.message || 'Error fetching rank data' }));
+
+    return true;
+  }
+
+  if (message.action === 'viewer_qualified' && message.payload) {
+    viewerQualificationUploader.enqueue(message.payload)
+      .then(result => sendResponse({ success: true, ...result }))
+      .catch(error => sendResponse({ success: false, error: error.message }));
+    return true;
+  }
+
   if (message.action === 'fetch_rank_by_puuid') {
     const puuid = message.puuid;
     
@@ -595,6 +2498,7 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
   
   if (message.action === 'set_current_user') {
     userRankCache.setCurrentUser(message.username);
+    rankCacheSnapshot.markDirty();
     sendResponse({ success: true });
     return false; // synchronous response
   }
@@ -637,38 +2541,82 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
   }
   
   if (message.action === 'clear_rank_cache_except_current_user') {
-    // Clear all cached entries except current user to allow detection of newly joined EloWard users
-    const currentUser = userRankCache.currentUser;
-    const currentUserData = currentUser ? userRankCache.cache.get(currentUser) : null;
-    
-    userRankCache.cache.clear();
+    // Mark everything except the current user stale rather than dropping it: badges keep
+    // rendering while refreshes pick up rank changes and newly joined EloWard users.
+    userRankCache.markStale();
     
-    // Restore current user's data if it exists
-    if (currentUser && currentUserData) {
-      userRankCache.cache.set(currentUser, currentUserData);
+    sendResponse({ success: true });
+    return false; // synchronous response
+  }
+  
+  if (message.action === 'tab_register') {
+    const tabId = sender?.tab?.id;
+    if (tabId === undefined || tabId === null) {
+      // Not a tab (e.g. an extension page): it gets every role so nothing is skipped
+      sendResponse({ success: true, leader: true, channelOwner: true });
+      return false;
     }
-    
-    // Don't persist mostly-empty cache - let natural cache population trigger persistence
+    tabRegistry.register(tabId, message.channel)
+      .then(roles => sendResponse({ success: true, ...roles }))
+      .catch(error => sendResponse({ success: false, error: error.message }));
+    return true;
+  }
+
+  if (message.action === 'get_badge_asset') {
+    const { key, url, version } = message;
+    // Only badge images from our CDN go into the store
+    if (!/^[a-z_]+$/.test(String(key)) || !/^\d+$/.test(String(version)) ||
+        typeof url !== 'string' || !url.startsWith(`${BADGE_CDN_BASE}/lol/`)) {
+      sendResponse({ success: false, error: 'Invalid badge request' });
+      return false;
+    }
+    badgeAssetStore.get(key, url, String(version))
+      .then(dataUrl => sendResponse({ success: true, dataUrl }))
+      .catch(error => sendResponse({ success: false, error: error.message }));
+    return true;
+  }
+
+  if (message.action === 'inject_chat_engine' && sender?.tab?.id !== undefined) {
+    injectChatEngine(sender.tab.id, sender.frameId || 0)
+      .then(() => sendResponse({ success: true }))
+      .catch(error => sendResponse({ success: false, error: error.message }));
+    return true;
+  }
+
+  if (message.action === 'prefetch_channel_ranks' && message.channel) {
+    channelRankPrefetcher.prefetch(message.channel)
+      .then(loaded => sendResponse({ success: true, loaded }))
+      .catch(() => sendResponse({ success: false, loaded: 0 }));
+    return true;
+  }
+
+  if (message.action === 'revalidate_ranks' && Array.isArray(message.usernames)) {
+    message.usernames.forEach(username => userRankCache.revalidateIfStale(username));
     sendResponse({ success: true });
     return false; // synchronous response
   }
   
   if (message.action === 'clear_user_rank_cache' && message.username) {
     const username = message.username.toLowerCase();
-    if (userRankCache.cache.has(username)) {
-      userRankCache.cache.delete(username);
-      maybePersistRankCache(userRankCache).catch(() => {});
-    }
+    userRankCache.delete(username);
     sendResponse({ success: true });
     return false; // synchronous response
   }
   
   if (message.action === 'get_all_cached_ranks') {
     const allRanks = {};
-    for (const [username, entry] of userRankCache.cache.entries()) {
-      // Only include positive cache entries (actual rank data)
-      if (entry.rankData !== NO_RANK_MARKER) {
-        allRanks[username] = entry.rankData;
+    if (Array.isArray(message.usernames)) {
+      // Just the asked-for users, without counting the read as a use
+      for (const username of message.usernames) {
+        const rankData = userRankCache.peek(username);
+        if (rankData && rankData !== NO_RANK_MARKER) allRanks[String(username).toLowerCase()] = rankData;
+      }
+    } else {
+      for (const [username, entry] of userRankCache.entries()) {
+        // Only include positive cache entries (actual rank data)
+        if (entry.rankData !== NO_RANK_MARKER) {
+          allRanks[username] = entry.rankData;
+        }
       }
     }
     sendResponse({ ranks: allRanks });
@@ -677,16 +2625,8 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
 
   if (message.action === 'prune_unranked_rank_cache') {
     try {
-      for (const [username, entry] of Array.from(userRankCache.cache.entries())) {
-        const rankData = entry?.rankData;
-        const tier = rankData?.tier;
-        
-        // Remove both negative cache entries and unranked entries
-        if (rankData === NO_RANK_MARKER || !tier || String(tier).toUpperCase() === 'UNRANKED') {
-          userRankCache.cache.delete(username);
-        }
-      }
-      maybePersistRankCache(userRankCache).catch(() => {});
+      // Negative and unranked entries are the ones likely to change; refresh them on next use
+      userRankCache.markStale({ lowSignalOnly: true });
       sendResponse({ success: true });
     } catch (e) {
       sendResponse({ success: false, error: e?.message || 'prune failed' });
@@ -694,158 +2634,19 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
     return false; // synchronous
   }
 
-  if (message.action === 'auto_refresh_rank') {
-    (async () => {
-      try {
-        const now = Date.now();
-        const { eloward_last_rank_refresh_at: lastRefreshAt } = await browser.storage.local.get(['eloward_last_rank_refresh_at']);
-
-        const shouldRefresh = !lastRefreshAt || (now - Number(lastRefreshAt) >= RANK_REFRESH_INTERVAL_MS);
-
-        // Verify Riot is authenticated and we have stored riot data before attempting refresh
-        let canRefresh = false;
-        try { canRefresh = await RiotAuth.isAuthenticated(true); } catch (_) { canRefresh = false; }
-        let hasStoredRiot = false;
-        try {
-          const riotStored = await browser.storage.local.get(['eloward_persistent_riot_user_data']);
-          hasStoredRiot = !!riotStored?.eloward_persistent_riot_user_data?.puuid;
-        } catch (_) { hasStoredRiot = false; }
-
-        if (shouldRefresh && canRefresh && hasStoredRiot) {
-          // Log to page console via content script
-          try {
-            browser.tabs.query({ active: true, currentWindow: true }).then(tabs => {
-              if (tabs[0]?.url?.includes('twitch.tv')) {
-                browser.tabs.sendMessage(tabs[0].id, { 
-                  type: 'console_log', 
-                  message: '[EloWard] Auto rank refresh triggered' 
-                }).catch(() => {});
-              }
-            });
-          } catch (_) {}
-          
-          try {
-            // Get PUUID from persistent storage instead of making token-based API call
-            const persistentRiotData = await PersistentStorage.getRiotUserData();
-            if (!persistentRiotData || !persistentRiotData.puuid) {
-              throw new Error('Missing PUUID in persistent storage');
-            }
-
-            // Fetch options data FIRST to ensure backend has latest settings
-            const optionsData = await fetchOptionsDataByPuuid(persistentRiotData.puuid);
-            if (optionsData) {
-              await updateLocalOptionsData(optionsData);
-            }
-            
-            // Now refresh rank data - backend will return correct rank (current/peak) based on database settings
-            const refreshedRankData = await RiotAuth.refreshRank(persistentRiotData.puuid);
-            
-            // Backend returns the correct rank (current or peak) based on user's show_peak setting
-            // Update the persistent data with new rank information  
-            const updatedUserData = {
-              ...persistentRiotData,
-              soloQueueRank: {
-                tier: refreshedRankData.rank_tier,
-                division: refreshedRankData.rank_division,
-                leaguePoints: refreshedRankData.lp
-              },
-              plus_active: optionsData.plus_active ? 1 : 0,
-              show_peak: optionsData.show_peak,
-              animate_badge: optionsData.animate_badge
-            };
-            
-            await PersistentStorage.storeRiotUserData(updatedUserData);
-
-            // Update background cache entry for local user (if we know Twitch username)
-            const twitchData = await PersistentStorage.getTwitchUserData();
-            const twitchUsername = twitchData.login.toLowerCase();
-            const region = refreshedRankData.region;
-            
-            if (twitchUsername && updatedUserData) {
-              const solo = updatedUserData.soloQueueRank;
-              const rankData = solo ? {
-                tier: solo.tier,
-                division: solo.division,
-                leaguePoints: solo.leaguePoints,
-                summonerName: updatedUserData.riotId,
-                region,
-                animate_badge: optionsData.animate_badge
-              } : {
-                tier: 'UNRANKED',
-                division: '',
-                leaguePoints: null,
-                summonerName: updatedUserData.riotId,
-                region,
-                animate_badge: optionsData.animate_badge
-              };
-              userRankCache.set(twitchUsername, rankData);
-            }
-
-            await browser.storage.local.set({ eloward_last_rank_refresh_at: now });
-            
-            // Log completion to page console
-            try {
-              browser.tabs.query({ active: true, currentWindow: true }).then(tabs => {
-                if (tabs[0]?.url?.includes('twitch.tv')) {
-                  browser.tabs.sendMessage(tabs[0].id, { 
-                    type: 'console_log', 
-                    message: '[EloWard] Auto rank refresh completed' 
-                  }).catch(() => {});
-                }
-              });
-            } catch (_) {}
-            
-            sendResponse({ success: true, refreshed: true });
-          } catch (e) {
-            // Log failure to page console
-            try {
-              browser.tabs.query({ active: true, currentWindow: true }).then(tabs => {
-                if (tabs[0]?.url?.includes('twitch.tv')) {
-                  browser.tabs.sendMessage(tabs[0].id, { 
-                    type: 'console_log', 
-                    message: `[EloWard] Auto rank refresh failed: ${e?.message || 'unknown error'}` 
-                  }).catch(() => {});
-                }
-              });
-            } catch (_) {}
-            
-            // Auto-refresh failed - skip gracefully without altering stored data or triggering popups
-            sendResponse({ success: false, refreshed: false, error: e?.message || 'refresh failed' });
-          }
-        } else {
-          // Simple reason logging for why refresh didn't trigger
-          let reason = '';
-          if (!shouldRefresh) {
-            const minutesSinceLast = lastRefreshAt ? Math.round((now - Number(lastRefreshAt)) / 60000) : 0;
-            reason = `too soon (${minutesSinceLast} minutes since last refresh)`;
-          } else if (!canRefresh) {
-            reason = 'Riot account not authenticated';
-          } else if (!hasStoredRiot) {
-            reason = 'no Riot account data stored';
-          }
-          
-          // Log to page console
-          try {
-            browser.tabs.query({ active: true, currentWindow: true }).then(tabs => {
-              if (tabs[0]?.url?.includes('twitch.tv')) {
-                browser.tabs.sendMessage(tabs[0].id, { 
-                  type: 'console_log', 
-                  message: `[EloWard] Auto rank refresh not triggered: ${reason}` 
-                }).catch(() => {});
-              }
-            });
-          } catch (_) {}
-          
-          sendResponse({ success: true, refreshed: false });
-        }
-      } catch (e) {
-        console.log('[EloWard] Auto rank refresh error:', e?.message || 'unexpected error');
-        sendResponse({ success: false, refreshed: false, error: e?.message || 'unexpected' });
-      }
-    })();
+  if (message.action === 'get_popup_view_model') {
+    popupViewModel.get()
+      .then(viewModel => sendResponse({ success: true, viewModel }))
+      .catch(error => sendResponse({ success: false, error: error?.message || 'view model unavailable' }));
     return true;
   }
 
+  if (message.action === 'local_user_chat_activity') {
+    rankRefreshScheduler.noteActivity().catch(() => {});
+    sendResponse({ success: true });
+    return false;
+  }
+
   if (message.action === 'refresh_options_data') {
     (async () => {
       try {
@@ -937,14 +2738,13 @@ browser.runtime.onMessage.addListener((message, sender, sendResponse) => {
     }
     
     try {
-      const cacheEntry = userRankCache.cache.get(username);
-      if (cacheEntry && cacheEntry.rankData) {
+      const cachedRankData = userRankCache.peek(username);
+      if (cachedRankData && cachedRankData !== NO_RANK_MARKER) {
         // Update the cache entry with the new field value
-        cacheEntry.rankData[field] = value;
-        cacheEntry.timestamp = Date.now(); // Update timestamp to keep it fresh
+        cachedRankData[field] = value;
         
-        // Re-set to update frequency and persist changes
-        userRankCache.set(username, cacheEntry.rankData);
+        // Re-set to refresh timestamp, update frequency and mark its snapshot shard dirty
+        userRankCache.set(username, cachedRankData);
         
         console.log(`[Background] Updated user cache ${field} to ${value} for ${username}`);
         sendResponse({ success: true });
@@ -1008,6 +2808,15 @@ browser.runtime.onInstalled.addListener((details) => {
         'eloward_twitch_tokens'
       ]);
     } catch (_) {}
+
+    // Badge images moved from base64 data URLs in storage.local to Cache Storage; drop the old copies once
+    try {
+      const allData = await browser.storage.local.get(null);
+      const legacyBadgeKeys = Object.keys(allData).filter(key => key.startsWith('eloward_content_badge_'));
+      if (legacyBadgeKeys.length > 0) {
+        await browser.storage.local.remove(legacyBadgeKeys);
+      }
+    } catch (_) {}
   };
 
   if (details.reason === 'install') {
@@ -1056,6 +2865,7 @@ browser.runtime.onInstalled.addListener((details) => {
         'riot_auth',
         RANK_CACHE_STORAGE_KEY,
         RANK_CACHE_UPDATED_AT_KEY,
+        ...RANK_CACHE_SHARD_KEYS,
         // Now unused token-based keys (migrated to server-side auth)
         'eloward_riot_access_token',
         'eloward_riot_refresh_token',
@@ -1069,6 +2879,18 @@ browser.runtime.onInstalled.addListener((details) => {
     } catch (_) {}
   })();
 
+// Relay Twitch SPA navigations to the tab's content script. Only present where the
+// webNavigation permission is granted (Firefox); Chrome tabs use the Navigation API instead.
+if (browser.webNavigation && browser.webNavigation.onHistoryStateUpdated) {
+  browser.webNavigation.onHistoryStateUpdated.addListener((details) => {
+    if (details.frameId !== 0) return;
+    browser.tabs.sendMessage(details.tabId, {
+      type: 'eloward_history_state_updated',
+      url: details.url
+    }).catch(() => {});
+  }, { url: [{ hostSuffix: 'twitch.tv' }] });
+}
+
 function clearAllStoredData() {
   return new Promise((resolve) => {
     try {
@@ -1211,34 +3033,92 @@ async function updatePersistentRiotDataFromRankData(rankData) {
   }
 }
 
+// Resolves null only for a 404 (no rank); network errors and 5xx throw so callers keep what they have
 async function fetchRankFromDatabase(twitchUsername) {
   if (!twitchUsername) return null;
   
-  try {
-    const normalizedUsername = twitchUsername.toLowerCase();
-    
-    const response = await fetch(`${RANK_WORKER_API_URL}/api/ranks/lol/${normalizedUsername}`);
-    
-    if (!response.ok) {
-      if (response.status === 404) {
-        return null;
-      }
-      throw new Error(`API error: ${response.status} ${response.statusText}`);
+  const normalizedUsername = twitchUsername.toLowerCase();
+  const metricsStart = EloWardMetrics.start();
+  const response = await fetch(`${RANK_WORKER_API_URL}/api/ranks/lol/${normalizedUsername}`);
+  EloWardMetrics.end('rank_lookup.single_ms', metricsStart);
+  
+  if (!response.ok) {
+    if (response.status === 404) {
+      return null;
     }
-    
-    const rankData = await response.json();
-    // Do not return sensitive identifiers like PUUID to content scripts
-    return {
-      tier: rankData.rank_tier,
-      division: rankData.rank_division,
-      leaguePoints: rankData.lp,
-      summonerName: rankData.riot_id,
-      region: rankData.region,
-      animate_badge: rankData.animate_badge || false
-    };
-  } catch (error) {
-    return null;
+    const error = new Error(`API error: ${response.status} ${response.statusText}`);
+    error.status = response.status;
+    throw error;
+  }
+  
+  const rankData = await response.json();
+  // Do not return sensitive identifiers like PUUID to content scripts
+  return mapRankRow(rankData);
+}
+
+/**
+ * Fetch rank data for many Twitch usernames with a single request to the rank worker
+ * @param {string[]} usernames - Normalized Twitch usernames
+ * @returns {Promise<Object>} Map of username to rank data (null when the user has no rank)
+ */
+async function fetchRanksFromDatabaseBatch(usernames) {
+  EloWardMetrics.count('rank_lookup.batch_users', usernames.length);
+  const metricsStart = EloWardMetrics.start();
+  const response = await fetch(`${RANK_WORKER_API_URL}/api/ranks/lol/batch`, {
+    method: 'POST',
+    headers: {
+      'Content-Type': 'application/json'
+    },
+    body: JSON.stringify({ usernames })
+  });
+  EloWardMetrics.end('rank_lookup.batch_ms', metricsStart);
+
+  if (!response.ok) {
+    const error = new Error(`Batch API error: ${response.status} ${response.statusText}`);
+    error.status = response.status;
+    throw error;
+  }
+
+  const data = await response.json();
+  const rows = data?.ranks || {};
+  const ranksByUsername = {};
+
+  for (const username of usernames) {
+    // Missing rows are users without rank data (negative cache entries)
+    ranksByUsername[username] = rows[username] ? mapRankRow(rows[username]) : null;
+  }
+
+  return ranksByUsername;
+}
+
+function mapRankRow(rankData) {
+  return {
+    tier: rankData.rank_tier,
+    division: rankData.rank_division,
+    leaguePoints: rankData.lp,
+    summonerName: rankData.riot_id,
+    region: rankData.region,
+    animate_badge: rankData.animate_badge || false
+  };
+}
+
+// Linked accounts recently seen in a channel (from the daily viewer sets), keyed by Twitch username
+async function fetchChannelRanks(channel, limit = CHANNEL_PREFETCH_LIMIT) {
+  const response = await fetch(`${RANK_WORKER_API_URL}/api/ranks/lol/channel/${encodeURIComponent(channel)}?limit=${limit}`);
+
+  if (!response.ok) {
+    const error = new Error(`Channel API error: ${response.status} ${response.statusText}`);
+    error.status = response.status;
+    throw error;
+  }
+
+  const data = await response.json();
+  const rows = data?.ranks || {};
+  const ranksByUsername = {};
+  for (const [username, row] of Object.entries(rows)) {
+    if (username && row) ranksByUsername[username.toLowerCase()] = mapRankRow(row);
   }
+  return ranksByUsername;
 }
 
 async function fetchRankByPuuid(puuid) {
@@ -1323,14 +3203,15 @@ async function fetchOptionsDataByPuuid(puuid) {
 async function updateLocalOptionsData(optionsData) {
   try {
     // Update eloward_user_options in local storage
-    const currentOptions = await browser.storage.local.get(['eloward_user_options']);
+    const currentOptions = await StorageMirror.get(['eloward_user_options']);
     const updatedOptions = {
       ...(currentOptions.eloward_user_options || {}),
       ...optionsData,
       cached_at: Date.now()
     };
     
-    await browser.storage.local.set({
+    // Both updates go out as one storage write
+    const optionsWrite = StorageMirror.set({
       eloward_user_options: updatedOptions
     });
     
@@ -1340,6 +3221,7 @@ async function updateLocalOptionsData(optionsData) {
       show_peak: optionsData.show_peak,
       animate_badge: optionsData.animate_badge
     });
+    await optionsWrite;
   } catch (error) {
     console.error('[Background] Error updating local options data:', error);
     throw error;
@@ -1354,14 +3236,15 @@ async function fetchRankByTwitchUsername(twitchUsername) {
     if (linkedAccount) {
       try {
         const rankData = await getRankForLinkedAccount();
+        userRankCache.set(twitchUsername, rankData);
         return rankData;
       } catch (error) {
         // Fall through to database lookup
       }
     }
     
-    // Fall back to database lookup
-    const dbRankData = await fetchRankFromDatabase(twitchUsername);
+    // Fall back to database lookup, coalesced with other pending lookups
+    const dbRankData = await rankLookupBatcher.enqueue(twitchUsername);
     return dbRankData;
   } catch (error) {
     return null;
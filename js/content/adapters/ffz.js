@@ -0,0 +1,25 @@
+/* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
+
+// FrankerFaceZ badge placement, imported by content.js once FFZ chat is detected
+
+export function createAdapter({ BadgeRenderer, updateBadgeElement, findBadgeContainer }) {
+  function render(messageContainer, _usernameElement, rankData) {
+    // FFZ should use the same badge container approach as standard mode
+    const badgeContainer = findBadgeContainer(messageContainer);
+    
+    if (!badgeContainer) {
+      console.warn('EloWard: Could not find or create badge container for FFZ message');
+      return;
+    }
+    // Update if present
+    const existing = badgeContainer.querySelector('.eloward-rank-badge');
+    if (existing) {
+      updateBadgeElement(existing, rankData);
+      return;
+    }
+
+    badgeContainer.appendChild(BadgeRenderer.clone(rankData, 'ffz').fragment);
+  }
+
+  return { render };
+}
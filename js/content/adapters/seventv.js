@@ -0,0 +1,49 @@
+/* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
+
+// 7TV badge placement, imported by content.js once 7TV chat is detected (live and VOD)
+
+export function createAdapter({ BadgeRenderer, updateBadgeElement }) {
+  function render(messageContainer, _usernameElement, rankData) {
+    // Anchor at the top-level 7TV message wrapper to avoid matching mention tokens
+    const userWrapper = messageContainer.closest('.seventv-user-message') || messageContainer.closest('.seventv-chat-vod-message-patched') || messageContainer;
+    const chatUser = userWrapper.querySelector('.seventv-chat-user');
+    let badgeList = chatUser ? chatUser.querySelector('.seventv-chat-user-badge-list') : null;
+    let badgeListWasEmpty = false;
+    
+    if (!badgeList) {
+      if (!chatUser) return;
+      
+      badgeList = document.createElement('span');
+      badgeList.className = 'seventv-chat-user-badge-list';
+      badgeListWasEmpty = true;
+      
+      const usernameEl = chatUser.querySelector('.seventv-chat-user-username');
+      if (usernameEl) {
+        chatUser.insertBefore(badgeList, usernameEl);
+      } else {
+        chatUser.insertBefore(badgeList, chatUser.firstChild);
+      }
+    } else {
+      // Check if badge list only contains non-badge elements or is empty
+      const existingBadges = badgeList.querySelectorAll('.seventv-chat-badge:not(.eloward-rank-badge)');
+      badgeListWasEmpty = existingBadges.length === 0;
+    }
+
+    const existing = badgeList.querySelector('.eloward-rank-badge');
+    if (existing) {
+      updateBadgeElement(existing, rankData);
+      return;
+    }
+    
+    const { fragment, badge } = BadgeRenderer.clone(rankData, 'seventv');
+    
+    // If this is the only badge, adjust positioning to align with username
+    if (badgeListWasEmpty) {
+      badge.classList.add('eloward-single-badge');
+    }
+    
+    badgeList.appendChild(fragment);
+  }
+
+  return { render };
+}
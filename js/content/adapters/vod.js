@@ -0,0 +1,41 @@
+/* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
+
+// Native Twitch VOD chat replay badge placement, imported by content.js on /videos/ pages
+
+export function createAdapter({ BadgeRenderer, updateBadgeElement }) {
+  function render(messageContainer, usernameElement, rankData) {
+    try {
+      // Find the VOD row container that holds badges + author + message
+      const vodRow = usernameElement.closest('.dtSdDz') || usernameElement.closest('.vod-message') || messageContainer;
+      if (!vodRow) return;
+      
+      // Prefer the first span before the author anchor as a badge host (matches live layout spacing)
+      let badgeHost = null;
+      const siblings = Array.from(vodRow.childNodes);
+      for (const node of siblings) {
+        if (node.nodeType === Node.ELEMENT_NODE && node.tagName === 'SPAN') {
+          badgeHost = node; break;
+        }
+        if (node === usernameElement) break;
+      }
+      if (!badgeHost) {
+        badgeHost = document.createElement('span');
+        badgeHost.className = 'eloward-badges-host';
+        vodRow.insertBefore(badgeHost, usernameElement);
+      }
+      
+      // Update existing badge if present
+      const existing = badgeHost.querySelector('.eloward-rank-badge');
+      if (existing) {
+        updateBadgeElement(existing, rankData);
+        return;
+      }
+      
+      badgeHost.appendChild(BadgeRenderer.clone(rankData, 'standard').fragment);
+    } catch (e) {
+      console.warn('EloWard (VOD): Failed to add badge', e);
+    }
+  }
+
+  return { render };
+}
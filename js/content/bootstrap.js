@@ -0,0 +1,215 @@
+/* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
+
+// First stage of the Twitch content script, loaded on every twitch.tv page. It only looks at
+// the route and, for channels, the live category; the chat engine (metrics.js + content.js)
+// is injected by the background once the tab can show League chat, and suspended again when
+// it navigates somewhere it cannot. The engine is injected at most once per page, since its
+// top-level declarations cannot be evaluated twice in the same content script scope.
+
+document.body.setAttribute('data-eloward-chrome-ext', 'active');
+document.documentElement.setAttribute('data-eloward-chrome-ext', 'active');
+
+const SUPPORTED_GAMES = { 'League of Legends': true };
+
+function isGameSupported(game) {
+  if (!game) return false;
+
+  if (SUPPORTED_GAMES[game] === true) {
+    return true;
+  }
+
+  const gameLower = game.toLowerCase();
+  for (const supportedGame of Object.keys(SUPPORTED_GAMES)) {
+    if (supportedGame.toLowerCase() === gameLower) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+const EloWardBootstrap = (() => {
+  // The engine reuses a precheck this recent instead of querying GQL again
+  const CATEGORY_REUSE_MS = 15000;
+  // A live channel in another category is rechecked this often while the tab is visible
+  const CATEGORY_RECHECK_MS = 5 * 60 * 1000;
+  // First path segments that are Twitch pages rather than channels
+  const NON_CHANNEL_ROUTES = new Set([
+    'directory', 'settings', 'search', 'downloads', 'jobs', 'p', 'turbo', 'prime', 'subscriptions',
+    'inventory', 'wallet', 'drops', 'friends', 'messages', 'payments', 'store', 'bits', 'following',
+    'popout', 'embed', 'videos', 'login', 'signup', 'oauth2', 'passport-callback'
+  ]);
+
+  let lastPathname = null;
+  let engineState = 'none'; // none | injecting | active | suspended
+  let suspendAfterInjection = false;
+  let evaluationId = 0;
+  let recheckTimer = null;
+  let recentCategory = null; // { channel, live, game, at }
+
+  // Mirrors the route handling in content.js getCurrentChannelName; VOD owners come from the DOM
+  function classifyRoute(pathname) {
+    if (pathname.includes('oauth2') || pathname.includes('auth/')) return { chat: false };
+    if (/^\/videos\/\d+/.test(pathname)) return { chat: true, channel: null };
+
+    const chatRoute = pathname.match(/^\/(?:popout\/u|popout\/moderator|popout|embed)\/([^/]+)\/(?:stream-manager\/)?chat/) ||
+      pathname.match(/^\/moderator\/([^/]+)/);
+    if (chatRoute) return { chat: true, channel: chatRoute[1].toLowerCase() };
+
+    const segment = pathname.split('/')[1];
+    if (!segment || NON_CHANNEL_ROUTES.has(segment.toLowerCase())) return { chat: false };
+    return { chat: true, channel: segment.toLowerCase() };
+  }
+
+  // Live stream category, or null when the lookup fails (the engine then decides from the DOM)
+  async function fetchCategory(channel) {
+    try {
+      const response = await fetch('https://gql.twitch.tv/gql', {
+        method: 'POST',
+        headers: {
+          'Content-Type': 'application/json',
+          'Client-ID': 'kimne78kx3ncx6brgo4mv6wki5h1ko'
+        },
+        body: JSON.stringify({
+          query: `query { user(login: "${channel}") { stream { game { name displayName } } } }`
+        })
+      });
+      if (!response.ok) return null;
+      const data = await response.json();
+      const stream = data?.data?.user?.stream;
+      const category = {
+        channel,
+        live: !!stream,
+        game: stream?.game ? (stream.game.name || stream.game.displayName) : null,
+        at: Date.now()
+      };
+      recentCategory = category;
+      return category;
+    } catch (_) {
+      return null;
+    }
+  }
+
+  function startEngine() {
+    suspendAfterInjection = false;
+    if (engineState === 'active' || engineState === 'injecting') return;
+
+    if (engineState === 'suspended') {
+      engineState = 'active';
+      EloWardEngine.resume();
+      return;
+    }
+
+    engineState = 'injecting';
+    try {
+      chrome.runtime.sendMessage({ action: 'inject_chat_engine' }, (response) => {
+        void chrome.runtime.lastError;
+        if (!response?.success || typeof EloWardEngine === 'undefined') {
+          engineState = 'none'; // Retried on the next navigation
+          return;
+        }
+        engineState = 'active';
+        if (suspendAfterInjection) suspendEngine();
+      });
+    } catch (_) {
+      engineState = 'none';
+    }
+  }
+
+  function suspendEngine() {
+    if (engineState === 'injecting') {
+      suspendAfterInjection = true;
+      return;
+    }
+    if (engineState !== 'active') return;
+    engineState = 'suspended';
+    EloWardEngine.suspend();
+  }
+
+  function scheduleRecheck(channel) {
+    clearTimeout(recheckTimer);
+    recheckTimer = setTimeout(async () => {
+      recheckTimer = null;
+      if (classifyRoute(window.location.pathname).channel !== channel) return;
+      if (document.visibilityState === 'hidden') {
+        scheduleRecheck(channel);
+        return;
+      }
+      const category = await fetchCategory(channel);
+      if (category?.live && isGameSupported(category.game)) {
+        startEngine();
+      } else {
+        scheduleRecheck(channel);
+      }
+    }, CATEGORY_RECHECK_MS);
+  }
+
+  async function evaluate() {
+    const pathname = window.location.pathname;
+    if (pathname === lastPathname) return;
+    lastPathname = pathname;
+
+    const id = ++evaluationId;
+    clearTimeout(recheckTimer);
+    recheckTimer = null;
+
+    const route = classifyRoute(pathname);
+    if (!route.chat) {
+      suspendEngine();
+      return;
+    }
+
+    // A running engine follows the navigation itself and reports back if the category is unsupported
+    if (engineState === 'active') {
+      EloWardEngine.navigate();
+      return;
+    }
+
+    if (route.channel) {
+      const category = await fetchCategory(route.channel);
+      if (id !== evaluationId) return;
+      // Offline channels, failed lookups and VODs are left to the engine's DOM-based detection
+      if (category?.live && !isGameSupported(category.game)) {
+        suspendEngine();
+        scheduleRecheck(route.channel);
+        return;
+      }
+    }
+
+    startEngine();
+  }
+
+  // Called by the engine when it finds the page's category unsupported
+  function releaseEngine() {
+    suspendEngine();
+    const channel = classifyRoute(window.location.pathname).channel;
+    if (channel) scheduleRecheck(channel);
+  }
+
+  function recentCategoryFor(channel) {
+    if (!recentCategory || recentCategory.channel !== channel) return null;
+    return Date.now() - recentCategory.at < CATEGORY_REUSE_MS ? recentCategory : null;
+  }
+
+  function init() {
+    // Chrome: the Navigation API reports every same-document navigation Twitch makes
+    if (window.navigation && typeof window.navigation.addEventListener === 'function') {
+      window.navigation.addEventListener('navigatesuccess', evaluate);
+    }
+
+    // Back/forward everywhere; Firefox also gets history updates relayed by the background
+    // (eloward_history_state_updated, from webNavigation.onHistoryStateUpdated)
+    window.addEventListener('popstate', evaluate);
+    try {
+      chrome.runtime.onMessage.addListener((message) => {
+        if (message && message.type === 'eloward_history_state_updated') evaluate();
+      });
+    } catch (_) {}
+
+    evaluate();
+  }
+
+  return { init, releaseEngine, recentCategoryFor, classifyRoute };
+})();
+
+EloWardBootstrap.init();
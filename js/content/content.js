@@ -1,8 +1,5 @@
 /* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
 
-document.body.setAttribute('data-eloward-chrome-ext', 'active');
-document.documentElement.setAttribute('data-eloward-chrome-ext', 'active');
-
 // Fast badge rendering: preconnect + image cache for all rank badges
 const CDN_BASE = 'https://eloward-cdn.unleashai.workers.dev';
 const RANK_TIERS = [
@@ -31,56 +28,140 @@ function injectPreconnectLinks() {
   } catch (_) {}
 }
 
+// Role of this tab among all open Twitch tabs, assigned by the background tab registry.
+// The leader does shared maintenance (storage cleanup);
+// the channel owner is the one tab per channel that runs viewer tracking. If the background
+// can't be reached the tab acts alone and takes every role, as before the registry existed.
+const TabCoordinator = (() => {
+  const ROLE_TIMEOUT_MS = 3000;
+  const STANDALONE_ROLE = { leader: true, channelOwner: true };
+  let role = null;
+  let registered = false;
+  const roleWaiters = [];
+  const roleListeners = [];
+
+  function applyRole(nextRole) {
+    const previous = role || { leader: false, channelOwner: false };
+    role = { leader: !!nextRole.leader, channelOwner: !!nextRole.channelOwner };
+    roleWaiters.splice(0).forEach(resolve => resolve(role));
+    if (previous.leader !== role.leader || previous.channelOwner !== role.channelOwner) {
+      roleListeners.forEach((listener) => {
+        try { listener(role, previous); } catch (_) {}
+      });
+    }
+  }
+
+  function register(channel = null) {
+    registered = true;
+    try {
+      chrome.runtime.sendMessage({ action: 'tab_register', channel }, (response) => {
+        if (chrome.runtime.lastError || !response?.success) {
+          applyRole(STANDALONE_ROLE);
+          return;
+        }
+        applyRole(response);
+      });
+    } catch (_) {
+      applyRole(STANDALONE_ROLE);
+    }
+  }
+
+  function whenRole() {
+    if (role) return Promise.resolve(role);
+    if (!registered) register();
+    return new Promise((resolve) => {
+      roleWaiters.push(resolve);
+      setTimeout(() => {
+        if (!role) applyRole(STANDALONE_ROLE);
+      }, ROLE_TIMEOUT_MS);
+    });
+  }
+
+  try {
+    chrome.runtime.onMessage.addListener((message) => {
+      if (message?.type === 'eloward_tab_role') applyRole(message);
+    });
+  } catch (_) {}
+
+  return {
+    register,
+    whenRole,
+    onRoleChange: (listener) => roleListeners.push(listener),
+    // Unknown until the registry answers; tracking starts and is stopped if another tab owns the channel
+    ownsChannel: () => !role || role.channelOwner
+  };
+})();
+
 const ImageCache = (() => {
   const tierToBlobUrl = new Map();
   const inFlight = new Map();
-  const persistentCache = new Map(); // Store data URLs from persistent storage
   
   // Badge cache versioning - increment when CDN images are updated  
   const BADGE_CACHE_VERSION = '3';
 
-  // Persistent cache functions
+  // Badge bytes are kept in the background's Cache Storage (a content script's caches would
+  // belong to twitch.tv) and arrive as data URLs, turned into blob URLs here.
+  // Names every older version stored in the page origin, cleared by the leader tab.
+  const PAGE_BADGE_STORE_PREFIX = 'eloward-badge';
 
-  async function setCachedBadgeBlob(tierKey, blob, isAnimated = false) {
-    try {
-      const suffix = isAnimated ? '_premium' : '';
-      const storageKey = `eloward_content_badge_${tierKey}${suffix}_v${BADGE_CACHE_VERSION}`;
-      
-      // Convert blob to data URL for storage
-      const dataUrl = await new Promise((resolve) => {
-        const reader = new FileReader();
-        reader.onloadend = () => resolve(reader.result);
-        reader.readAsDataURL(blob);
-      });
-      
-      await browser.storage.local.set({
-        [storageKey]: {
-          dataUrl,
-          timestamp: Date.now()
-        }
-      });
-    } catch (_) {
-      // Ignore storage errors
-    }
+  function badgeUrl(tierKey, isAnimated) {
+    const baseUrl = isAnimated ? `${CDN_BASE}/lol/${tierKey}_premium.webp` : `${CDN_BASE}/lol/${tierKey}.png`;
+    return `${baseUrl}?v=${BADGE_CACHE_VERSION}`;
   }
 
-  // Clean up old cached badges
-  async function cleanupOldContentBadgeCache() {
+  // Drop the badge caches earlier versions kept in twitch.tv's Cache Storage
+  async function cleanupPageBadgeStores() {
     try {
-      const allData = await browser.storage.local.get();
-      const keysToRemove = Object.keys(allData).filter(key => 
-        key.startsWith('eloward_content_badge_') && 
-        !key.includes(`_v${BADGE_CACHE_VERSION}`)
-      );
-      
-      if (keysToRemove.length > 0) {
-        await browser.storage.local.remove(keysToRemove);
-      }
+      if (typeof caches === 'undefined') return;
+      const names = await caches.keys();
+      await Promise.all(names
+        .filter(name => name.startsWith(PAGE_BADGE_STORE_PREFIX))
+        .map(name => caches.delete(name)));
     } catch (_) {
       // Ignore cleanup errors
     }
   }
 
+  function blobUrlFromDataUrl(dataUrl) {
+    const comma = dataUrl.indexOf(',');
+    const type = dataUrl.slice(5, comma).split(';')[0] || 'image/png';
+    const binary = atob(dataUrl.slice(comma + 1));
+    const bytes = new Uint8Array(binary.length);
+    for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+    return URL.createObjectURL(new Blob([bytes], { type }));
+  }
+
+  function loadBadge(key, url) {
+    const promise = new Promise((resolve) => {
+      // Fallback to CDN URL on failure
+      const fallback = () => {
+        tierToBlobUrl.set(key, url);
+        resolve(url);
+      };
+      try {
+        chrome.runtime.sendMessage({ action: 'get_badge_asset', key, url, version: BADGE_CACHE_VERSION }, (response) => {
+          if (chrome.runtime.lastError || !response?.success || !response.dataUrl) {
+            fallback();
+            return;
+          }
+          try {
+            const blobUrl = blobUrlFromDataUrl(response.dataUrl);
+            tierToBlobUrl.set(key, blobUrl);
+            resolve(blobUrl);
+          } catch (_) {
+            fallback();
+          }
+        });
+      } catch (_) {
+        fallback();
+      }
+    }).finally(() => {
+      inFlight.delete(key);
+    });
+    inFlight.set(key, promise);
+    return promise;
+  }
+
   async function preloadTier(tierLower) {
     const key = String(tierLower || '').toLowerCase();
     if (!key) return null;
@@ -91,74 +172,12 @@ const ImageCache = (() => {
     
     const promises = [];
     
-    // Preload regular variant  
     if (!tierToBlobUrl.has(regularKey) && !inFlight.has(regularKey)) {
-      const regularPromise = (async () => {
-        try {
-          // Check if we have it in persistent cache first
-          if (persistentCache.has(regularKey)) {
-            const blobUrl = await convertCachedDataUrlToBlobUrl(regularKey);
-            if (blobUrl) return blobUrl;
-          }
-          
-          // Not in persistent cache - fetch from CDN
-          const regularUrl = `${CDN_BASE}/lol/${key}.png?v=${BADGE_CACHE_VERSION}`;
-          const resp = await fetch(regularUrl, { mode: 'cors', cache: 'default', credentials: 'omit' });
-          if (!resp.ok) throw new Error(String(resp.status));
-          const blob = await resp.blob();
-          const blobUrl = URL.createObjectURL(blob);
-          
-          // Store in both memory and persistent cache
-          tierToBlobUrl.set(regularKey, blobUrl);
-          setCachedBadgeBlob(key, blob, false).catch(() => {}); // Non-blocking
-          
-          return blobUrl;
-          } catch (_) {
-            // Fallback to CDN URL on failure
-            const fallbackUrl = `${CDN_BASE}/lol/${key}.png?v=${BADGE_CACHE_VERSION}`;
-            tierToBlobUrl.set(regularKey, fallbackUrl);
-            return fallbackUrl;
-        } finally {
-          inFlight.delete(regularKey);
-        }
-      })();
-      inFlight.set(regularKey, regularPromise);
-      promises.push(regularPromise);
+      promises.push(loadBadge(regularKey, badgeUrl(key, false)));
     }
     
-    // Preload premium variant
     if (!tierToBlobUrl.has(premiumKey) && !inFlight.has(premiumKey)) {
-      const premiumPromise = (async () => {
-        try {
-          // Check if we have it in persistent cache first
-          if (persistentCache.has(premiumKey)) {
-            const blobUrl = await convertCachedDataUrlToBlobUrl(premiumKey);
-            if (blobUrl) return blobUrl;
-          }
-          
-          // Not in persistent cache - fetch from CDN
-          const premiumUrl = `${CDN_BASE}/lol/${key}_premium.webp?v=${BADGE_CACHE_VERSION}`;
-          const resp = await fetch(premiumUrl, { mode: 'cors', cache: 'default', credentials: 'omit' });
-          if (!resp.ok) throw new Error(String(resp.status));
-          const blob = await resp.blob();
-          const blobUrl = URL.createObjectURL(blob);
-          
-          // Store in both memory and persistent cache
-          tierToBlobUrl.set(premiumKey, blobUrl);
-          setCachedBadgeBlob(key, blob, true).catch(() => {}); // Non-blocking
-          
-          return blobUrl;
-          } catch (_) {
-            // Fallback to CDN URL on failure
-            const fallbackUrl = `${CDN_BASE}/lol/${key}_premium.webp?v=${BADGE_CACHE_VERSION}`;
-            tierToBlobUrl.set(premiumKey, fallbackUrl);
-            return fallbackUrl;
-        } finally {
-          inFlight.delete(premiumKey);
-        }
-      })();
-      inFlight.set(premiumKey, premiumPromise);
-      promises.push(premiumPromise);
+      promises.push(loadBadge(premiumKey, badgeUrl(key, true)));
     }
     
     // Return promise for regular variant (for backwards compatibility)
@@ -168,65 +187,19 @@ const ImageCache = (() => {
   async function init() {
     injectPreconnectLinks();
     
-    // Load persistent cache data URLs into memory (fast, non-blocking)
-    loadPersistentCacheData().catch(() => {});
-    
-    // Clean up old badge cache entries (non-blocking)
-    cleanupOldContentBadgeCache().catch(() => {});
+    // Clean up page-origin badge stores (non-blocking, leader tab only)
+    TabCoordinator.whenRole().then((role) => {
+      if (role.leader) cleanupPageBadgeStores().catch(() => {});
+    });
     
-    // Preload common badges (now more efficient since it checks persistent cache first)
     try {
       await Promise.all(RANK_TIERS.map(preloadTier));
     } catch (_) {}
   }
-  
-  // Load persistent cache data URLs into memory for fast access
-  async function loadPersistentCacheData() {
-    try {
-      const allData = await browser.storage.local.get();
-      const cacheKeys = Object.keys(allData).filter(key => 
-        key.startsWith('eloward_content_badge_') && 
-        key.includes(`_v${BADGE_CACHE_VERSION}`)
-      );
-      
-      for (const storageKey of cacheKeys) {
-        const cached = allData[storageKey];
-        if (cached && cached.dataUrl) {
-          // Extract tier key from storage key format: eloward_content_badge_{tier}_{suffix}_v{version}
-          const match = storageKey.match(/^eloward_content_badge_(.+)_v\d+$/);
-          if (match) {
-            const key = match[1]; // e.g., "gold" or "gold_premium"
-            // Store data URL for lazy conversion to blob URL when needed
-            persistentCache.set(key, cached.dataUrl);
-          }
-        }
-      }
-    } catch (_) {
-      // Continue if persistent cache loading fails
-    }
-  }
-  
-  // Convert cached data URL to blob URL (lazy conversion)
-  async function convertCachedDataUrlToBlobUrl(key) {
-    try {
-      const dataUrl = persistentCache.get(key);
-      if (dataUrl) {
-        const response = await fetch(dataUrl);
-        const blob = await response.blob();
-        const blobUrl = URL.createObjectURL(blob);
-        tierToBlobUrl.set(key, blobUrl);
-        return blobUrl;
-      }
-      return null;
-    } catch (_) {
-      return null;
-    }
-  }
 
   function getSrcSync(tier, isAnimated = false) {
     const tierKey = String(tier || 'unranked').toLowerCase();
     const key = isAnimated ? `${tierKey}_premium` : tierKey;
-    const extension = isAnimated ? '.webp' : '.png';
     
     // Check memory cache first (blob URLs - fastest)
     const cachedBlobUrl = tierToBlobUrl.get(key);
@@ -234,20 +207,11 @@ const ImageCache = (() => {
       return cachedBlobUrl;
     }
     
-    // Check persistent cache (data URLs - fast)  
-    if (persistentCache.has(key)) {
-      // Convert to blob URL in background for next time
-      convertCachedDataUrlToBlobUrl(key).catch(() => {});
-      // Return data URL immediately (works for img.src)
-      return persistentCache.get(key);
-    }
-    
     // Cache miss - trigger preloading for future use
     preloadTier(tierKey).catch(() => {});
     
     // Return CDN URL as immediate fallback with cache-busting
-    const baseUrl = isAnimated ? `${CDN_BASE}/lol/${tierKey}_premium.webp` : `${CDN_BASE}/lol/${tierKey}.png`;
-    return `${baseUrl}?v=${BADGE_CACHE_VERSION}`;
+    return badgeUrl(tierKey, isAnimated);
   }
 
   function revokeAll() {
@@ -258,7 +222,6 @@ const ImageCache = (() => {
         }
       }
       tierToBlobUrl.clear();
-      persistentCache.clear(); // Also clear persistent cache data
     } catch (_) {}
   }
 
@@ -288,6 +251,74 @@ const extensionState = {
 // Expose extensionState globally for debugging and potential future extensions
 window.elowardExtensionState = extensionState;
 
+// Debug overlay for EloWardMetrics: this tab's counters and timings plus the background's,
+// refreshed once a second while shown. Toggle from the console with
+// window.elowardExtensionState.metrics.toggleHud(); showing it switches metrics on.
+const MetricsHud = (() => {
+  const REFRESH_MS = 1000;
+  let panel = null;
+  let timer = null;
+  let backgroundSnapshot = null;
+
+  function formatSnapshot(title, snapshot) {
+    if (!snapshot) return `${title}: n/a`;
+    const lines = [`${title}${snapshot.enabled ? '' : ' (disabled)'}`];
+    for (const [name, value] of Object.entries(snapshot.counters || {}).sort()) {
+      lines.push(`  ${name}: ${value}`);
+    }
+    for (const [name, histogram] of Object.entries(snapshot.histograms || {}).sort()) {
+      lines.push(`  ${name}: n=${histogram.count} p50<=${histogram.p50} p95<=${histogram.p95} max=${histogram.max}`);
+    }
+    return lines.join('\n');
+  }
+
+  function render() {
+    if (!panel) return;
+    try {
+      chrome.runtime.sendMessage({ action: 'get_metrics', includeTabs: false }, (response) => {
+        void chrome.runtime.lastError;
+        if (response?.success) backgroundSnapshot = response.metrics.background;
+      });
+    } catch (_) {}
+    panel.textContent = `${formatSnapshot('Tab', EloWardMetrics.snapshot())}\n\n${formatSnapshot('Background', backgroundSnapshot)}`;
+  }
+
+  function show() {
+    if (panel) return;
+    try { chrome.storage.local.set({ [EloWardMetrics.ENABLED_KEY]: true }); } catch (_) {}
+    panel = document.createElement('pre');
+    panel.className = 'eloward-metrics-hud';
+    document.body.appendChild(panel);
+    render();
+    timer = setInterval(render, REFRESH_MS);
+  }
+
+  function hide() {
+    if (timer) clearInterval(timer);
+    timer = null;
+    if (panel) panel.remove();
+    panel = null;
+  }
+
+  function toggleHud() {
+    if (panel) {
+      hide();
+    } else {
+      show();
+    }
+    return !!panel;
+  }
+
+  return { toggleHud, hide };
+})();
+
+extensionState.metrics = {
+  toggleHud: MetricsHud.toggleHud,
+  snapshot: () => EloWardMetrics.snapshot(),
+  reset: () => EloWardMetrics.reset()
+};
+
+
 // ============================================================================
 // VIEWER TRACKING INTEGRATION
 // Triggers whenever channel becomes active (streaming League of Legends)
@@ -295,15 +326,111 @@ window.elowardExtensionState = extensionState;
 
 let viewerTrackingState = {
   isTracking: false,
-  trackingIntervalId: null,
-  playTimeSeconds: 0,
-  lastUpdateTime: null,
+  deadlineTimerId: null,
+  playTimeSeconds: 0, // Seconds accrued before the current segment started
+  lastUpdateTime: null, // Start of the current segment (ms)
+  statDate: null,
+  riotPuuid: null,
   qualificationsSentToday: new Set(), // Track by channel_date
   currentTrackingChannel: null
 };
 
 const VIEWER_QUALIFY_THRESHOLD = 300; // Production: 5 minutes (300 seconds)
 const VIEWER_BACKEND_URL = 'https://eloward-users.unleashai.workers.dev';
+const VIEWER_CHECKPOINT_PREFIX = 'eloward_viewer_';
+let pendingViewerQualification = null; // Payload awaiting an outbox ack from the background
+
+// Progress is derived from timestamps rather than counted by a ticking timer:
+// the only wakeups are one timeout at the threshold deadline plus checkpoints
+// on visibilitychange/pagehide. Background-tab throttling can delay the
+// deadline timer but cannot lose time, since elapsed time comes from Date.now().
+
+function getViewerCheckpointKey(channel, statDate) {
+  return `${VIEWER_CHECKPOINT_PREFIX}${channel.toLowerCase()}_${statDate}`;
+}
+
+function readViewerCheckpoint(channel, statDate) {
+  try {
+    const raw = localStorage.getItem(getViewerCheckpointKey(channel, statDate));
+    const parsed = raw ? JSON.parse(raw) : null;
+    if (parsed && typeof parsed.seconds === 'number') return parsed;
+  } catch (_) {}
+  return { seconds: 0, qualified: false };
+}
+
+function writeViewerCheckpoint(channel, statDate, checkpoint) {
+  try {
+    localStorage.setItem(getViewerCheckpointKey(channel, statDate), JSON.stringify(checkpoint));
+  } catch (_) {}
+}
+
+/**
+ * Drop checkpoints from windows that can no longer be submitted
+ * (the backend accepts the current and previous stat_date only)
+ */
+function pruneViewerCheckpoints(statDate) {
+  try {
+    const previous = new Date(`${statDate}T00:00:00Z`);
+    previous.setUTCDate(previous.getUTCDate() - 1);
+    const keep = new Set([statDate, previous.toISOString().slice(0, 10)]);
+    for (let i = localStorage.length - 1; i >= 0; i--) {
+      const key = localStorage.key(i);
+      if (!key || !key.startsWith(VIEWER_CHECKPOINT_PREFIX)) continue;
+      const date = key.slice(-10);
+      if (!keep.has(date)) localStorage.removeItem(key);
+    }
+  } catch (_) {}
+}
+
+function getViewerElapsedSeconds(now = Date.now()) {
+  if (!viewerTrackingState.lastUpdateTime) return viewerTrackingState.playTimeSeconds;
+  return viewerTrackingState.playTimeSeconds + (now - viewerTrackingState.lastUpdateTime) / 1000;
+}
+
+/**
+ * Fold the running segment into playTimeSeconds and persist it
+ */
+function checkpointViewerProgress() {
+  if (!viewerTrackingState.isTracking || !viewerTrackingState.lastUpdateTime) return;
+  // Once the stream has left League the running segment is not watch time
+  if (!extensionState.isChannelActive) return;
+
+  const now = Date.now();
+  viewerTrackingState.playTimeSeconds = getViewerElapsedSeconds(now);
+  viewerTrackingState.lastUpdateTime = now;
+
+  writeViewerCheckpoint(viewerTrackingState.currentTrackingChannel, viewerTrackingState.statDate, {
+    seconds: Math.floor(viewerTrackingState.playTimeSeconds),
+    qualified: false
+  });
+}
+
+function scheduleViewerDeadline() {
+  if (viewerTrackingState.deadlineTimerId) {
+    clearTimeout(viewerTrackingState.deadlineTimerId);
+  }
+  const remainingMs = Math.max(0, (VIEWER_QUALIFY_THRESHOLD - getViewerElapsedSeconds()) * 1000);
+  viewerTrackingState.deadlineTimerId = setTimeout(() => {
+    viewerTrackingState.deadlineTimerId = null;
+    updateViewerPlayTime(viewerTrackingState.riotPuuid);
+  }, remainingMs);
+}
+
+function handleViewerVisibilityChange() {
+  if (!viewerTrackingState.isTracking) return;
+  if (document.visibilityState === 'hidden') {
+    checkpointViewerProgress();
+  } else {
+    // A throttled deadline timer may still be pending past its due time
+    updateViewerPlayTime(viewerTrackingState.riotPuuid);
+  }
+}
+
+document.addEventListener('visibilitychange', handleViewerVisibilityChange);
+window.addEventListener('pagehide', () => {
+  checkpointViewerProgress();
+  beaconPendingViewerQualification();
+});
 
 /**
  * Start viewer tracking for current channel
@@ -322,6 +449,10 @@ function startViewerTracking() {
     console.log('[EloWard Viewer] ⛔ Cannot start tracking - no channel name');
     return;
   }
+  if (!TabCoordinator.ownsChannel()) {
+    console.log(`[EloWard Viewer] Another tab is tracking ${extensionState.channelName}`);
+    return;
+  }
 
   // Don't track if already tracking the same channel
   if (viewerTrackingState.isTracking &&
@@ -330,7 +461,7 @@ function startViewerTracking() {
   }
 
   // Get viewer's Riot PUUID from storage
-  chrome.storage.local.get(['eloward_persistent_riot_user_data'], async (data) => {
+  EloWardStorage.get(['eloward_persistent_riot_user_data']).then(async (data) => {
     const riotPuuid = data?.eloward_persistent_riot_user_data?.puuid;
 
     if (!riotPuuid) {
@@ -345,25 +476,30 @@ function startViewerTracking() {
     // Check if already qualified today for this channel
     const today = getViewerWindow();
     const qualKey = `${extensionState.channelName}_${today}`;
+    const checkpoint = readViewerCheckpoint(extensionState.channelName, today);
 
+    if (checkpoint.qualified) {
+      viewerTrackingState.qualificationsSentToday.add(qualKey);
+    }
     if (viewerTrackingState.qualificationsSentToday.has(qualKey)) {
       console.log(`[EloWard Viewer] Already qualified today for ${extensionState.channelName}`);
       return;
     }
 
-    // Start tracking
+    pruneViewerCheckpoints(today);
+
+    // Start tracking, resuming any progress checkpointed by an earlier page load
     stopViewerTracking(); // Stop any previous tracking
     viewerTrackingState.isTracking = true;
     viewerTrackingState.currentTrackingChannel = extensionState.channelName;
-    viewerTrackingState.playTimeSeconds = 0;
+    viewerTrackingState.statDate = today;
+    viewerTrackingState.riotPuuid = riotPuuid;
+    viewerTrackingState.playTimeSeconds = Math.min(checkpoint.seconds, VIEWER_QUALIFY_THRESHOLD);
     viewerTrackingState.lastUpdateTime = Date.now();
 
-    console.log(`[EloWard Viewer] 🚀 Started tracking: ${extensionState.channelName} (${extensionState.currentGame})`);
+    console.log(`[EloWard Viewer] 🚀 Started tracking: ${extensionState.channelName} (${extensionState.currentGame}) at ${Math.floor(viewerTrackingState.playTimeSeconds)}s / ${VIEWER_QUALIFY_THRESHOLD}s`);
 
-    // Update every second
-    viewerTrackingState.trackingIntervalId = setInterval(() => {
-      updateViewerPlayTime(riotPuuid);
-    }, 1000);
+    scheduleViewerDeadline();
 
     // EXTRA SAFETY: Re-verify game category after 3 seconds
     // Catches race conditions where game detection completes after tracking starts
@@ -382,18 +518,21 @@ function startViewerTracking() {
  * Stop viewer tracking and clean up
  */
 function stopViewerTracking() {
-  if (viewerTrackingState.trackingIntervalId) {
-    clearInterval(viewerTrackingState.trackingIntervalId);
-    viewerTrackingState.trackingIntervalId = null;
+  checkpointViewerProgress();
+  if (viewerTrackingState.deadlineTimerId) {
+    clearTimeout(viewerTrackingState.deadlineTimerId);
+    viewerTrackingState.deadlineTimerId = null;
   }
   viewerTrackingState.isTracking = false;
   viewerTrackingState.playTimeSeconds = 0;
   viewerTrackingState.lastUpdateTime = null;
+  viewerTrackingState.statDate = null;
+  viewerTrackingState.riotPuuid = null;
   viewerTrackingState.currentTrackingChannel = null;
 }
 
 /**
- * Update play time and check for qualification
+ * Settle elapsed time and either qualify or re-arm the deadline timer
  */
 function updateViewerPlayTime(riotPuuid) {
   if (!viewerTrackingState.isTracking || !viewerTrackingState.lastUpdateTime) {
@@ -403,6 +542,7 @@ function updateViewerPlayTime(riotPuuid) {
   // Check if still on LoL stream
   if (!extensionState.isChannelActive) {
     console.log('[EloWard Viewer] Game changed, stopping tracking');
+    viewerTrackingState.lastUpdateTime = null; // Drop the segment since the switch
     stopViewerTracking();
     return;
   }
@@ -415,29 +555,44 @@ function updateViewerPlayTime(riotPuuid) {
     return;
   }
 
-  const now = Date.now();
-  const deltaSeconds = (now - viewerTrackingState.lastUpdateTime) / 1000;
-  viewerTrackingState.lastUpdateTime = now;
-  viewerTrackingState.playTimeSeconds += deltaSeconds;
-
-  // Log progress every 5 seconds
-  if (Math.floor(viewerTrackingState.playTimeSeconds) % 5 === 0 &&
-      viewerTrackingState.playTimeSeconds >= 5) {
-    console.log(`[EloWard Viewer] ⏱️  ${Math.floor(viewerTrackingState.playTimeSeconds)}s / ${VIEWER_QUALIFY_THRESHOLD}s`);
+  // Window rolled over at 07:00 UTC: progress belongs to the old stat_date
+  if (viewerTrackingState.statDate !== getViewerWindow()) {
+    console.log('[EloWard Viewer] Viewer window rolled over, restarting tracking');
+    stopViewerTracking();
+    startViewerTracking();
+    return;
   }
 
-  // Check if qualified
+  checkpointViewerProgress();
+
   if (viewerTrackingState.playTimeSeconds >= VIEWER_QUALIFY_THRESHOLD) {
     sendViewerQualification(riotPuuid);
+    return;
   }
+
+  console.log(`[EloWard Viewer] ⏱️  ${Math.floor(viewerTrackingState.playTimeSeconds)}s / ${VIEWER_QUALIFY_THRESHOLD}s`);
+  scheduleViewerDeadline();
 }
 
+// Only one tab per channel tracks; ownership moves when the owning tab closes or leaves.
+// Progress carries over through the shared localStorage checkpoint.
+TabCoordinator.onRoleChange((role, previous) => {
+  if (role.channelOwner && !previous.channelOwner) {
+    startViewerTracking();
+  } else if (!role.channelOwner && previous.channelOwner && viewerTrackingState.isTracking) {
+    console.log('[EloWard Viewer] Channel tracked by another tab, stopping');
+    stopViewerTracking();
+  }
+});
+
 /**
- * Send viewer qualification to backend
+ * Hand the qualification to the background uploader, which dedupes it across tabs
+ * and owns retries. The payload stays pending until the outbox acknowledges it so
+ * pagehide can still beacon it if the page goes away first.
  */
-async function sendViewerQualification(riotPuuid) {
+function sendViewerQualification(riotPuuid) {
   const channel = viewerTrackingState.currentTrackingChannel;
-  const today = getViewerWindow();
+  const today = viewerTrackingState.statDate || getViewerWindow();
   const qualKey = `${channel}_${today}`;
 
   // Stop tracking first (we're done)
@@ -448,26 +603,69 @@ async function sendViewerQualification(riotPuuid) {
     channel_twitch_id: channel.toLowerCase(),
     riot_puuid: riotPuuid
   };
+  pendingViewerQualification = payload;
+
+  console.log(`[EloWard Viewer] 📤 Queueing qualification for ${channel}...`);
+
+  const markQualified = () => {
+    if (pendingViewerQualification === payload) pendingViewerQualification = null;
+    viewerTrackingState.qualificationsSentToday.add(qualKey);
+    writeViewerCheckpoint(channel, today, { seconds: VIEWER_QUALIFY_THRESHOLD, qualified: true });
+  };
 
-  console.log(`[EloWard Viewer] 📤 Sending qualification for ${channel}...`);
+  try {
+    chrome.runtime.sendMessage({ action: 'viewer_qualified', payload }, (response) => {
+      if (chrome.runtime.lastError || !response?.success) {
+        // Background unreachable (e.g. extension reloaded): post directly as before
+        postViewerQualificationDirect(payload).then((ok) => {
+          if (ok) markQualified();
+        });
+        return;
+      }
+      markQualified();
+      console.log(response.alreadySent
+        ? `[EloWard Viewer] Already qualified today for ${channel}`
+        : `[EloWard Viewer] ✅ Qualification queued for ${channel}`);
+    });
+  } catch (_) {
+    postViewerQualificationDirect(payload).then((ok) => {
+      if (ok) markQualified();
+    });
+  }
+}
 
+async function postViewerQualificationDirect(payload) {
   try {
     const response = await fetch(`${VIEWER_BACKEND_URL}/view/qualify`, {
       method: 'POST',
       headers: { 'Content-Type': 'application/json' },
       body: JSON.stringify(payload)
     });
-
-    if (response.ok) {
-      viewerTrackingState.qualificationsSentToday.add(qualKey);
-      console.log(`[EloWard Viewer] ✅ Qualified successfully for ${channel}`);
-    } else {
-      const error = await response.text();
-      console.error(`[EloWard Viewer] ❌ Failed to qualify:`, error);
-    }
+    if (response.ok) return true;
+    console.error(`[EloWard Viewer] ❌ Failed to qualify:`, await response.text());
   } catch (error) {
     console.error(`[EloWard Viewer] ❌ Network error:`, error);
   }
+  return false;
+}
+
+/**
+ * Last-chance delivery for a qualification the background never acknowledged
+ */
+function beaconPendingViewerQualification() {
+  const payload = pendingViewerQualification;
+  if (!payload || !navigator.sendBeacon) return;
+  const url = `${VIEWER_BACKEND_URL}/view/qualify`;
+  const body = JSON.stringify(payload);
+  let sent = false;
+  try {
+    sent = navigator.sendBeacon(url, new Blob([body], { type: 'application/json' }));
+  } catch (_) {}
+  try {
+    // Browsers that refuse a non-simple beacon type get the same JSON as text/plain
+    if (!sent) sent = navigator.sendBeacon(url, body);
+  } catch (_) {}
+  if (sent) pendingViewerQualification = null;
 }
 
 /**
@@ -540,6 +738,27 @@ const SELECTORS = {
     ]
   }
 };
+
+// VOD wrappers that hold the real message one level down
+const VOD_MESSAGE_WRAPPER_SELECTOR = '.dtSdDz, .vod-message, .seventv-user-message, .seventv-chat-vod-message-patched';
+const VOD_INNER_MESSAGE_SELECTOR = '.video-chat__message, .seventv-user-message';
+
+// Selector lists joined once per chat mode; username selectors stay ordered by priority
+const compiledSelectors = new Map();
+
+function getCompiledSelectors(chatMode = extensionState.chatMode) {
+  let compiled = compiledSelectors.get(chatMode);
+  if (!compiled) {
+    const selectors = SELECTORS[chatMode] || SELECTORS.standard;
+    compiled = {
+      message: selectors.message.join(', '),
+      username: selectors.username
+    };
+    compiledSelectors.set(chatMode, compiled);
+  }
+  return compiled;
+}
+
 function isVodPage() {
   return /^\/videos\/(\d+)/.test(window.location.pathname);
 }
@@ -637,12 +856,114 @@ function getOfflineChannelGameFromDom() {
   return null;
 }
 
+// SUPPORTED_GAMES and isGameSupported come from bootstrap.js, which shares this script's scope
+
+// Weakly held so scrolled-off chat lines can be collected; reset by reassignment
+let processedMessages = new WeakSet();
+
+// Username -> live username elements in chat, so resolved ranks are applied by direct lookup.
+// Elements are held weakly; detached ones are dropped on access, collected ones by the finalizer.
+const BadgeTargets = (() => {
+  const PRUNE_EVERY = 500;
+  const targetsByUsername = new Map(); // username -> Set of WeakRefs
+  const refsByElement = new WeakMap(); // element -> { ref, username, signature }
+  const finalizer = new FinalizationRegistry(({ username, ref }) => {
+    removeRef(username, ref);
+  });
+  let registrationsSincePrune = 0;
+
+  function removeRef(username, ref) {
+    const refs = targetsByUsername.get(username);
+    if (!refs) return;
+    refs.delete(ref);
+    if (refs.size === 0) targetsByUsername.delete(username);
+  }
+
+  function register(username, element) {
+    if (!username || !element) return;
+    const existing = refsByElement.get(element);
+    if (existing) {
+      const stillIndexed = targetsByUsername.get(existing.username)?.has(existing.ref);
+      if (stillIndexed && existing.username === username) return;
+      if (stillIndexed) removeRef(existing.username, existing.ref);
+      finalizer.unregister(existing.ref);
+    }
+
+    const ref = new WeakRef(element);
+    refsByElement.set(element, { ref, username, signature: null });
+    finalizer.register(element, { username, ref }, ref);
+
+    let refs = targetsByUsername.get(username);
+    if (!refs) {
+      refs = new Set();
+      targetsByUsername.set(username, refs);
+    }
+    refs.add(ref);
+
+    if (++registrationsSincePrune >= PRUNE_EVERY) prune();
+  }
+
+  // Visit live targets for a username, dropping any that left the DOM
+  function forEach(username, callback) {
+    const refs = targetsByUsername.get(username);
+    if (!refs) return;
+    for (const ref of Array.from(refs)) {
+      const element = ref.deref();
+      if (!element || !element.isConnected) {
+        drop(username, ref, element);
+        continue;
+      }
+      callback(element);
+    }
+  }
+
+  function drop(username, ref, element) {
+    removeRef(username, ref);
+    finalizer.unregister(ref);
+    if (element) refsByElement.delete(element);
+  }
+
+  function prune() {
+    registrationsSincePrune = 0;
+    for (const [username, refs] of Array.from(targetsByUsername.entries())) {
+      for (const ref of Array.from(refs)) {
+        const element = ref.deref();
+        if (!element || !element.isConnected) drop(username, ref, element);
+      }
+    }
+  }
+
+  function rankSignature(rankData) {
+    return [
+      rankData.tier,
+      rankData.division || '',
+      rankData.leaguePoints ?? '',
+      rankData.summonerName || '',
+      rankData.region || '',
+      rankData.animate_badge ? 1 : 0
+    ].join('|');
+  }
+
+  function noteApplied(element, rankData) {
+    const record = refsByElement.get(element);
+    if (record) record.signature = rankSignature(rankData);
+  }
+
+  function hasApplied(element, rankData) {
+    const record = refsByElement.get(element);
+    return !!record && record.signature === rankSignature(rankData);
+  }
 
-const SUPPORTED_GAMES = { 'League of Legends': true };
+  function clear() {
+    for (const refs of targetsByUsername.values()) {
+      for (const ref of refs) finalizer.unregister(ref);
+    }
+    targetsByUsername.clear();
+    registrationsSincePrune = 0;
+  }
 
-let processedMessages = new Set();
-let pendingBadgeTargets = new Map();
-let tooltipElement = null;
+  return { register, forEach, noteApplied, hasApplied, clear, signatureOf: rankSignature };
+})();
 
 function findVodUsernameInfo(messageNode) {
   try {
@@ -692,14 +1013,12 @@ function getDisplayRegion(regionCode) {
   return display[code] || regionCode.toUpperCase();
 }
 
-function handleBadgeClick(event) {
-  const badge = event.currentTarget;
+function handleBadgeClick(badge) {
   const username = badge.dataset.username;
   const badgeRegion = badge.dataset.region;
   
 
   hideTooltip();
-  hideSevenTVTooltip();
   
   if (!username || !badgeRegion) return;
   
@@ -713,40 +1032,137 @@ function handleBadgeClick(event) {
   window.open(opGGUrl, '_blank');
 }
 
-function createBadgeElement(rankData) {
-  const badge = document.createElement('span');
+function applyBadgeData(badge, rankData) {
   const isAnimated = rankData.animate_badge || false;
-  
-  badge.className = 'eloward-rank-badge';
+
   badge.dataset.rankText = formatRankText(rankData);
   badge.dataset.rank = rankData.tier.toLowerCase();
   badge.dataset.division = rankData.division || '';
-  badge.dataset.lp = rankData.leaguePoints !== undefined && rankData.leaguePoints !== null ? 
+  badge.dataset.lp = rankData.leaguePoints !== undefined && rankData.leaguePoints !== null ?
                      rankData.leaguePoints.toString() : '';
   badge.dataset.username = rankData.summonerName || '';
-  badge.dataset.region = rankData.region;
+  badge.dataset.region = rankData.region || '';
   badge.dataset.isAnimated = isAnimated ? 'true' : 'false';
-  
-  const img = document.createElement('img');
-  img.alt = rankData.tier;
-  img.className = 'eloward-badge-img';
-  img.width = 24;
-  img.height = 24;
-  // Use cached blob URL if available; falls back to CDN URL
-  img.decoding = 'async';
-  try { img.fetchPriority = 'high'; } catch (_) {}
-  img.loading = 'eager';
-  img.src = ImageCache.getSrcSync(rankData.tier, isAnimated);
-  
-  badge.appendChild(img);
-  badge.addEventListener('mouseenter', showTooltip);
-  badge.addEventListener('mouseleave', hideTooltip);
-  badge.addEventListener('click', handleBadgeClick);
-  badge.style.cursor = 'pointer';
-  
-  return badge;
 }
 
+// Badge DOM is cloned from one prebuilt <template> per (tier, animated, chat mode).
+// Renders are queued and written in one batch per animation frame, capped at
+// BADGE_FRAME_BUDGET_MS of work; whatever doesn't fit rolls over to the next frame.
+const BADGE_FRAME_BUDGET_MS = 4;
+
+const BadgeRenderer = (() => {
+  const templates = new Map();
+  const queue = new Map(); // usernameElement -> latest rankData
+  let flushHandle = null;
+  const stats = { rendered: 0, frames: 0, deferredFrames: 0, totalMs: 0, maxMs: 0 };
+
+  function getTemplate(rankData, chatMode) {
+    const isAnimated = !!rankData.animate_badge;
+    const key = `${rankData.tier}|${isAnimated}|${chatMode}`;
+    let template = templates.get(key);
+    if (template) return template;
+
+    const img = document.createElement('img');
+    img.alt = rankData.tier;
+    img.className = 'eloward-badge-img';
+    img.width = 24;
+    img.height = 24;
+    img.decoding = 'async';
+    try { img.fetchPriority = 'high'; } catch (_) {}
+    img.loading = 'eager';
+
+    template = document.createElement('template');
+    if (chatMode === 'seventv') {
+      const badge = document.createElement('div');
+      badge.className = 'seventv-chat-badge eloward-rank-badge';
+      // Ensure rightmost position regardless of flex ordering
+      badge.style.order = '9999';
+      badge.style.cursor = 'pointer';
+      badge.appendChild(img);
+      template.content.appendChild(badge);
+    } else {
+      const badge = document.createElement('span');
+      badge.className = chatMode === 'ffz' ? 'eloward-rank-badge ffz-badge' : 'eloward-rank-badge';
+      badge.style.cursor = 'pointer';
+      badge.appendChild(img);
+      // Match live stream markup: wrap in a container div for consistent spacing
+      const badgeWrapper = document.createElement('div');
+      badgeWrapper.className = 'InjectLayout-sc-1i43xsx-0 dvtAVE';
+      badgeWrapper.appendChild(badge);
+      template.content.appendChild(badgeWrapper);
+    }
+
+    templates.set(key, template);
+    return template;
+  }
+
+  // Returns a fragment ready to insert plus the badge element inside it
+  function clone(rankData, chatMode = extensionState.chatMode) {
+    const fragment = getTemplate(rankData, chatMode).content.cloneNode(true);
+    const badge = fragment.querySelector('.eloward-rank-badge');
+    applyBadgeData(badge, rankData);
+
+    // Image source is resolved per clone so templates never pin a stale CDN fallback URL
+    badge.firstChild.src = ImageCache.getSrcSync(rankData.tier, rankData.animate_badge || false);
+
+    // Hover and click are handled by BadgeTooltips' delegated listeners on the chat container
+    return { fragment, badge };
+  }
+
+  function enqueue(usernameElement, rankData) {
+    queue.set(usernameElement, rankData);
+    schedule();
+  }
+
+  function schedule() {
+    if (flushHandle) return;
+    // rAF is paused in background tabs; fall back to a timer so hidden chats still get badges
+    if (document.hidden) {
+      flushHandle = { timeout: setTimeout(flush, 100) };
+    } else {
+      flushHandle = { frame: requestAnimationFrame(flush) };
+    }
+  }
+
+  function cancel() {
+    if (flushHandle) {
+      if (flushHandle.frame) cancelAnimationFrame(flushHandle.frame);
+      if (flushHandle.timeout) clearTimeout(flushHandle.timeout);
+      flushHandle = null;
+    }
+    queue.clear();
+  }
+
+  function flush() {
+    flushHandle = null;
+    stats.frames++;
+    const frameStart = performance.now();
+
+    for (const [usernameElement, rankData] of queue) {
+      if (performance.now() - frameStart >= BADGE_FRAME_BUDGET_MS) {
+        stats.deferredFrames++;
+        schedule();
+        return;
+      }
+
+      queue.delete(usernameElement);
+      if (!usernameElement.isConnected) continue;
+
+      const renderStart = performance.now();
+      renderBadge(usernameElement, rankData);
+      const elapsed = performance.now() - renderStart;
+      stats.rendered++;
+      stats.totalMs += elapsed;
+      if (elapsed > stats.maxMs) stats.maxMs = elapsed;
+      EloWardMetrics.observe('badge.render_ms', elapsed);
+    }
+  }
+
+  return { clone, enqueue, cancel, stats };
+})();
+
+extensionState.badgeRenderStats = BadgeRenderer.stats;
+
 function detectChatMode() {
   // Comprehensive 7TV detection - if ANY of these indicators are present, 7TV is active
   const has7TVElements = !!(
@@ -782,6 +1198,8 @@ function detectChatMode() {
   const previousMode = extensionState.chatMode;
   extensionState.compatibilityMode = detectedMode !== 'standard';
   extensionState.chatMode = detectedMode;
+  // Start fetching the mode's badge adapter now so it is parsed before the first badge
+  BadgeAdapters.load(BadgeAdapters.nameFor(detectedMode, isVodPage()));
   
   if (detectedMode !== previousMode && extensionState.initializationComplete) {
     console.log(`🔄 EloWard: Chat mode changed from ${previousMode} to ${detectedMode}`);
@@ -799,7 +1217,7 @@ function switchChatMode() {
   console.log(`🔄 EloWard: Switching to ${extensionState.chatMode} mode`);
   
   cleanupChatObserver();
-  processedMessages.clear();
+  processedMessages = new WeakSet();
   
   const chatContainer = findChatContainer();
   if (chatContainer) {
@@ -808,26 +1226,217 @@ function switchChatMode() {
 }
 
 function cleanupChatObserver() {
-  if (tooltipElement && tooltipElement.parentNode) {
-    tooltipElement.parentNode.removeChild(tooltipElement);
-    tooltipElement = null;
-  }
-  
-  hideSevenTVTooltip();
+  BadgeTooltips.detach();
   
   if (window._eloward_chat_observer) {
     window._eloward_chat_observer.disconnect();
     window._eloward_chat_observer = null;
   }
+  ChatScheduler.clear();
+  MessageVisibility.clear();
+  BadgeRenderer.cancel();
+  BadgeTargets.clear();
   
   document.querySelectorAll('.eloward-rank-badge').forEach(badge => {
     badge.remove();
   });
 }
 
+/**
+ * DomWatch - one shared MutationObserver per root for every DOM waiter in the content script.
+ * watch({ selector, callback, root, once, attributes, childList, immediate, timeout, onTimeout })
+ * calls callback(element, source) for added nodes matching `selector` (or any added node when
+ * selector is null) and for changes to the listed `attributes`. `once` waiters unregister after
+ * their first hit; `timeout` unregisters them after a deadline. Added nodes are first tested
+ * against all selectors of a root combined, and a root's observer disconnects as soon as its
+ * last waiter is gone. Returns an unwatch function.
+ */
+const DomWatch = (() => {
+  const roots = new Map(); // root -> { observer, watchers: Set, combined, optionsKey }
+
+  function watch({
+    selector = null,
+    callback,
+    root = document.body,
+    once = false,
+    attributes = null,
+    childList = true,
+    immediate = true,
+    timeout = 0,
+    onTimeout = null
+  }) {
+    if (!root || typeof callback !== 'function') return () => {};
+
+    const watcher = { selector, callback, once, attributes, childList, active: true, timer: null };
+    watcher.unwatch = () => remove(root, watcher);
+
+    // Already present: satisfy the waiter without observing at all
+    if (immediate && selector) {
+      const existing = root.matches && root.matches(selector) ? root : root.querySelector(selector);
+      if (existing) {
+        try { callback(existing, null); } catch (_) {}
+        if (once) {
+          watcher.active = false;
+          return watcher.unwatch;
+        }
+      }
+    }
+
+    let entry = roots.get(root);
+    if (!entry) {
+      entry = { observer: new MutationObserver((mutations) => {
+        const metricsStart = EloWardMetrics.start();
+        dispatch(root, mutations);
+        EloWardMetrics.end('observer.callback_ms', metricsStart);
+      }), watchers: new Set(), combined: null, optionsKey: '' };
+      roots.set(root, entry);
+    }
+    entry.watchers.add(watcher);
+    refresh(root, entry);
+
+    if (timeout > 0) {
+      watcher.timer = setTimeout(() => {
+        if (!watcher.active) return;
+        watcher.unwatch();
+        if (onTimeout) {
+          try { onTimeout(); } catch (_) {}
+        }
+      }, timeout);
+    }
+
+    return watcher.unwatch;
+  }
+
+  function remove(root, watcher) {
+    watcher.active = false;
+    if (watcher.timer) {
+      clearTimeout(watcher.timer);
+      watcher.timer = null;
+    }
+
+    const entry = roots.get(root);
+    if (!entry || !entry.watchers.delete(watcher)) return;
+    refresh(root, entry);
+  }
+
+  // Recompute the observer options and combined selector after watchers change
+  function refresh(root, entry) {
+    if (entry.watchers.size === 0) {
+      entry.observer.disconnect();
+      roots.delete(root);
+      return;
+    }
+
+    let childList = false;
+    let matchAnyNode = false;
+    const selectors = [];
+    const attributeFilter = new Set();
+    for (const watcher of entry.watchers) {
+      if (watcher.childList) {
+        childList = true;
+        if (watcher.selector) selectors.push(watcher.selector);
+        else matchAnyNode = true;
+      }
+      if (watcher.attributes) watcher.attributes.forEach(name => attributeFilter.add(name));
+    }
+
+    // Only worth a combined pre-test when several selectors share the root
+    entry.combined = !matchAnyNode && selectors.length > 1 ? selectors.join(', ') : null;
+
+    const options = { childList, subtree: true };
+    if (attributeFilter.size > 0) {
+      options.attributes = true;
+      options.attributeFilter = Array.from(attributeFilter);
+    }
+    const optionsKey = JSON.stringify(options);
+    if (optionsKey !== entry.optionsKey) {
+      // Re-observing the same root replaces its options
+      entry.observer.observe(root, options);
+      entry.optionsKey = optionsKey;
+    }
+  }
+
+  function fire(watcher, element, source) {
+    if (!watcher.active) return;
+    if (watcher.once) watcher.unwatch();
+    try { watcher.callback(element, source); } catch (_) {}
+  }
+
+  function dispatch(root, mutations) {
+    const entry = roots.get(root);
+    if (!entry) return;
+    const watchers = Array.from(entry.watchers);
+
+    for (const mutation of mutations) {
+      if (mutation.type === 'childList') {
+        for (const node of mutation.addedNodes) {
+          if (node.nodeType !== Node.ELEMENT_NODE) continue;
+          if (entry.combined && !node.matches(entry.combined) && !node.querySelector(entry.combined)) continue;
+
+          for (const watcher of watchers) {
+            if (!watcher.active || !watcher.childList) continue;
+            if (!watcher.selector) {
+              fire(watcher, node, node);
+              continue;
+            }
+            const match = node.matches(watcher.selector) ? node : node.querySelector(watcher.selector);
+            if (match) fire(watcher, match, node);
+          }
+        }
+      } else if (mutation.type === 'attributes') {
+        for (const watcher of watchers) {
+          if (!watcher.active || !watcher.attributes || !watcher.attributes.includes(mutation.attributeName)) continue;
+          if (watcher.selector && !mutation.target.matches(watcher.selector)) continue;
+          fire(watcher, mutation.target, mutation);
+        }
+      }
+    }
+  }
+
+  return { watch };
+})();
+
+// Chat container candidates, in priority order; findChatContainer picks the first present
+const CHAT_CONTAINER_SELECTORS = [
+  '.chat-scrollable-area__message-container',
+  '[data-a-target="chat-scroller"]',
+  '.chat-list--default',
+  '.chat-list',
+  '.simplebar-content',
+  '[data-test-selector="chat-scrollable-area__message-container"]',
+  '.chat-room__content .simplebar-content',
+  '.ffz-chat-container',
+  '.seventv-chat-container',
+  // VOD-specific candidates
+  '[data-test-selector="video-chat__message-list"]',
+  '.video-chat__message-list',
+  '.video-chat__message-list-wrapper',
+  '[data-a-target="video-chat"] .simplebar-content',
+  '[data-a-target="video-chat"] [role="log"]'
+];
+const ANY_CHAT_MESSAGE_SELECTOR = '.chat-line__message, .chat-line, [data-a-target="chat-line-message"], .video-chat__message, [data-test-selector*="chat-message"]';
+const CHAT_READY_SELECTOR = `${CHAT_CONTAINER_SELECTORS.join(', ')}, ${ANY_CHAT_MESSAGE_SELECTOR}`;
+// Column that holds chat on channel and VOD pages; long waits watch it instead of the whole body
+const CHAT_COLUMN_SELECTOR = '.channel-root__right-column, .right-column';
+
+// Run `callback(chatContainer)` once chat is mounted under root, or give up after timeoutMs
+function whenChatContainerReady(callback, timeoutMs, root = document.body) {
+  return DomWatch.watch({
+    selector: CHAT_READY_SELECTOR,
+    root,
+    once: true,
+    timeout: timeoutMs,
+    callback: () => {
+      const chatContainer = findChatContainer();
+      if (chatContainer) callback(chatContainer);
+    }
+  });
+}
+
 function setupCompatibilityMonitor() {
   let detectionCount = 0;
   const maxDetections = 15;
+  const unwatchers = [];
   
   const scheduleFollowUpDetection = () => {
     if (detectionCount < maxDetections && extensionState.chatMode === 'standard') {
@@ -841,71 +1450,33 @@ function setupCompatibilityMonitor() {
   };
   
   scheduleFollowUpDetection();
-  
-  const compatibilityObserver = new MutationObserver((mutations) => {
+
+  const redetect = () => {
     if (detectionCount >= maxDetections) {
-      compatibilityObserver.disconnect();
+      unwatchers.forEach(unwatch => unwatch());
       return;
     }
-    
-    for (const mutation of mutations) {
-      if (mutation.type === 'childList') {
-        for (const node of mutation.addedNodes) {
-          if (node.nodeType === Node.ELEMENT_NODE) {
-            // Check for 7TV indicators
-            const has7TVIndicators = !!(
-              node.tagName === 'SEVENTV-CONTAINER' ||
-              node.id === 'seventv-settings-button' ||
-              node.querySelector && (
-                node.querySelector('seventv-container') ||
-                node.querySelector('#seventv-settings-button') ||
-                node.querySelector('.seventv-message') ||
-                node.classList.contains('seventv-paint')
-              )
-            );
-            
-            // Check for FFZ indicators
-            const hasFFZIndicators = !!(
-              node.querySelector && (
-                node.querySelector('.ffz-message-line') ||
-                node.classList.contains('ffz-addon')
-              )
-            );
-            
-            if (has7TVIndicators || hasFFZIndicators) {
-              if (detectionCount < maxDetections) {
-                detectionCount++;
-                detectChatMode();
-                return;
-              }
-            }
-          }
-        }
-      }
-      
-      // Also check for class changes on body element
-      if (mutation.type === 'attributes' && 
-          mutation.target === document.body && 
-          mutation.attributeName === 'class') {
-        if (detectionCount < maxDetections) {
-          detectionCount++;
-          detectChatMode();
-          return;
-        }
-      }
-    }
-  });
-  
-  compatibilityObserver.observe(document.body, {
-    childList: true,
-    subtree: true,
-    attributes: true,
-    attributeFilter: ['class', 'style']
-  });
-  
-  setTimeout(() => {
-    compatibilityObserver.disconnect();
-  }, 15000);
+    detectionCount++;
+    detectChatMode();
+  };
+
+  // 7TV / FFZ markers appearing anywhere on the page
+  unwatchers.push(DomWatch.watch({
+    selector: 'seventv-container, #seventv-settings-button, .seventv-message, .seventv-paint, .ffz-message-line, .ffz-addon',
+    immediate: false,
+    timeout: 15000,
+    callback: redetect
+  }));
+
+  // Also check for class changes on body element
+  unwatchers.push(DomWatch.watch({
+    selector: 'body',
+    attributes: ['class'],
+    childList: false,
+    immediate: false,
+    timeout: 15000,
+    callback: redetect
+  }));
 }
 
 function setupFallbackInitialization() {
@@ -916,26 +1487,30 @@ function setupFallbackInitialization() {
     }
   }, 10000);
   
-  const fallbackCheckInterval = setInterval(() => {
-    const currentChannel = getCurrentChannelName();
-    if (currentChannel && 
-        !extensionState.initializationComplete && 
-        !extensionState.initializationInProgress &&
-        !extensionState.fallbackInitialized &&
-        (Date.now() - extensionState.lastInitAttempt) > 15000) {
-      
-      extensionState.fallbackInitialized = true;
-      fallbackInitialization();
-      clearInterval(fallbackCheckInterval);
+  // Once chat is mounted, give the regular init 15s from its last attempt before falling back
+  const startedAt = Date.now();
+  const checkFallback = () => {
+    if (extensionState.initializationComplete || extensionState.fallbackInitialized) return;
+
+    const dueIn = extensionState.lastInitAttempt + 15000 - Date.now();
+    if (dueIn > 0 || extensionState.initializationInProgress || !getCurrentChannelName()) {
+      if (Date.now() - startedAt < 120000) setTimeout(checkFallback, Math.max(dueIn, 5000));
+      return;
     }
-  }, 5000);
-  
-  setTimeout(() => {
-    clearInterval(fallbackCheckInterval);
-  }, 120000);
+
+    extensionState.fallbackInitialized = true;
+    fallbackInitialization();
+  };
+
+  // Routes without chat (directory, settings) only get a short wait; chat routes watch the
+  // chat column once it exists rather than every mutation on the page
+  const routeHasChat = EloWardBootstrap.classifyRoute(window.location.pathname).chat;
+  const root = document.querySelector(CHAT_COLUMN_SELECTOR) || document.body;
+  whenChatContainerReady(() => setTimeout(checkFallback, 5000), routeHasChat ? 120000 : 10000, root);
 }
 
 async function fallbackInitialization() {
+  if (engineSuspended) return;
   const currentChannel = getCurrentChannelName();
   if (!currentChannel) return;
 
@@ -955,56 +1530,46 @@ async function fallbackInitialization() {
     }
   }
 
-  let attempts = 0;
-  const maxAttempts = 10;
-
-  async function tryFallbackSetup() {
-    const chatContainer = findChatContainer();
-
-    if (chatContainer) {
-      extensionState.channelName = currentChannel;
-      const detectedGame = await getCurrentGame();
-      extensionState.currentGame = detectedGame;
-
-      console.log(`🔄 EloWard Fallback: Detected game - ${detectedGame || 'none'}`);
+  whenChatContainerReady(async (chatContainer) => {
+    if (engineSuspended) return;
+    extensionState.channelName = currentChannel;
+    const detectedGame = await getCurrentGame();
+    extensionState.currentGame = detectedGame;
 
-      // Only activate if game is League of Legends
-      if (isGameSupported(detectedGame)) {
-        extensionState.isChannelActive = true;
-        console.log(`🚀 EloWard Fallback: Active for ${currentChannel} (${detectedGame})`);
+    console.log(`🔄 EloWard Fallback: Detected game - ${detectedGame || 'none'}`);
 
-        // Start viewer tracking (now has guards to prevent activation on non-LoL games)
-        startViewerTracking();
+    // Only activate if game is League of Legends
+    if (isGameSupported(detectedGame)) {
+      extensionState.isChannelActive = true;
+      console.log(`🚀 EloWard Fallback: Active for ${currentChannel} (${detectedGame})`);
 
-        setupChatObserver(chatContainer);
-        extensionState.observerInitialized = true;
-      } else {
-        extensionState.isChannelActive = false;
-        console.log(`⛔ EloWard Fallback: Not active - unsupported game: ${detectedGame || 'none'}`);
-      }
+      // Start viewer tracking (now has guards to prevent activation on non-LoL games)
+      startViewerTracking();
 
-      extensionState.initializationComplete = true;
+      setupChatObserver(chatContainer);
+      extensionState.observerInitialized = true;
     } else {
-      attempts++;
-      if (attempts < maxAttempts) {
-        setTimeout(tryFallbackSetup, attempts * 1000);
-      }
+      extensionState.isChannelActive = false;
+      console.log(`⛔ EloWard Fallback: Not active - unsupported game: ${detectedGame || 'none'}`);
     }
-  }
 
-  tryFallbackSetup();
+    extensionState.initializationComplete = true;
+    if (!extensionState.isChannelActive) EloWardBootstrap.releaseEngine();
+  }, 45000);
 }
 
 
 function cleanupChannel(channelName) {
   cleanupChatObserver();
+  stopViewerTracking();
+  TabCoordinator.register(null); // Hand channel ownership to another tab while this one moves on
   
   if (window._eloward_game_observer) {
     window._eloward_game_observer.disconnect();
     window._eloward_game_observer = null;
   }
   
-  processedMessages.clear();
+  processedMessages = new WeakSet();
   
   extensionState.observerInitialized = false;
   extensionState.isChannelActive = false;
@@ -1015,7 +1580,7 @@ function cleanupChannel(channelName) {
 
 function initializeStorage() {
   // Read only the keys we actually need to determine current user
-  chrome.storage.local.get(['eloward_persistent_twitch_user_data', 'twitchUsername'], (allData) => {
+  EloWardStorage.get(['eloward_persistent_twitch_user_data', 'twitchUsername']).then((allData) => {
     extensionState.currentUser = findCurrentUser(allData);
     
     if (extensionState.currentUser) {
@@ -1126,6 +1691,10 @@ async function getCurrentGame() {
   }
   if (!channelName) return null;
 
+  // 0) The bootstrap just asked GQL for this channel before injecting the engine
+  const precheck = EloWardBootstrap.recentCategoryFor(channelName);
+  if (precheck?.game) return precheck.game;
+
   // 1) Try Twitch GQL (works in Chrome; in Firefox we added host permission)
   try {
     const response = await fetch('https://gql.twitch.tv/gql', {
@@ -1190,23 +1759,6 @@ async function getCurrentGame() {
   return null;
 }
 
-function isGameSupported(game) {
-  if (!game) return false;
-  
-  if (SUPPORTED_GAMES[game] === true) {
-    return true;
-  }
-  
-  const gameLower = game.toLowerCase();
-  for (const supportedGame of Object.keys(SUPPORTED_GAMES)) {
-    if (supportedGame.toLowerCase() === gameLower) {
-      return true;
-    }
-  }
-  
-  return false;
-}
-
 function setupGameChangeObserver() {
   if (window._eloward_game_observer) {
     window._eloward_game_observer.disconnect();
@@ -1228,10 +1780,14 @@ function setupGameChangeObserver() {
         extensionState.currentGame = newGame;
         
         if (!isGameSupported(extensionState.currentGame)) {
+          // Settle League watch time up to the switch; nothing after it counts
+          stopViewerTracking();
           if (window._eloward_chat_observer) {
             window._eloward_chat_observer.disconnect();
             window._eloward_chat_observer = null;
           }
+          ChatScheduler.clear();
+          MessageVisibility.clear();
           extensionState.observerInitialized = false;
           extensionState.isChannelActive = false;
         } else if (isGameSupported(extensionState.currentGame) && !isGameSupported(oldGame)) {
@@ -1243,34 +1799,34 @@ function setupGameChangeObserver() {
     }, 1000);
   }
   
-  const gameObserver = new MutationObserver(checkGameChange);
   const streamInfoTarget = document.querySelector('[data-a-target="stream-info-card"], [data-test-selector="stream-info-card"]');
   
   // NEW: also observe offline channel header section
   const offlineInfoTarget = document.querySelector('#live-channel-stream-information, .channel-info-content');
   
+  const unwatchers = [];
   if (streamInfoTarget) {
-    gameObserver.observe(streamInfoTarget, { 
-      subtree: true, 
-      childList: true,
-      attributes: true,
-      attributeFilter: ['data-a-target', 'class', 'style']
-    });
+    unwatchers.push(DomWatch.watch({
+      root: streamInfoTarget,
+      attributes: ['data-a-target', 'class', 'style'],
+      immediate: false,
+      callback: checkGameChange
+    }));
   }
   if (offlineInfoTarget) {
-    gameObserver.observe(offlineInfoTarget, { 
-      subtree: true, 
-      childList: true,
-      attributes: true,
-      attributeFilter: ['class', 'style']
-    });
+    unwatchers.push(DomWatch.watch({
+      root: offlineInfoTarget,
+      attributes: ['class', 'style'],
+      immediate: false,
+      callback: checkGameChange
+    }));
   }
   
-  window._eloward_game_observer = gameObserver;
+  window._eloward_game_observer = { disconnect: () => unwatchers.forEach(unwatch => unwatch()) };
 }
 
 function initializeExtension() {
-  if (extensionState.initializationInProgress) return;
+  if (engineSuspended || extensionState.initializationInProgress) return;
   
   extensionState.lastInitAttempt = Date.now();
   
@@ -1283,7 +1839,17 @@ function initializeExtension() {
   extensionState.channelName = currentChannel;
   extensionState.isVod = isVodPage();
   extensionState.lastPathname = window.location.pathname;
+  BadgeAdapters.load(BadgeAdapters.nameFor(extensionState.chatMode, extensionState.isVod));
+  TabCoordinator.register(currentChannel);
+  RankCacheMirror.subscribe(currentChannel);
   
+  // Warm the rank cache with the channel's regulars while game detection runs; the
+  // background rate-limits per channel, and the loaded ranks reach this tab as mirror deltas
+  try {
+    chrome.runtime.sendMessage({ action: 'prefetch_channel_ranks', channel: currentChannel }, () => {
+      void chrome.runtime.lastError;
+    });
+  } catch (_) {}
   
   setTimeout(async () => {
     if (extensionState.currentInitializationId !== initializationId) return;
@@ -1298,6 +1864,7 @@ function initializeExtension() {
       console.log(`🚀 EloWard: Extension not active - unsupported game: ${extensionState.currentGame || 'none'}`);
       extensionState.initializationInProgress = false;
       extensionState.initializationComplete = true;
+      EloWardBootstrap.releaseEngine(); // Unload until the bootstrap sees a supported page again
       return;
     }
     
@@ -1311,98 +1878,121 @@ function initializeExtension() {
       if (!extensionState.observerInitialized) {
         initializeObserver();
       }
-      try {
-        chrome.storage.local.get(['eloward_persistent_connected_state','eloward_persistent_riot_user_data'], (data) => {
-          const connected = !!data?.eloward_persistent_connected_state?.riot;
-          const hasRiotData = !!data?.eloward_persistent_riot_user_data?.puuid;
-          if (connected || hasRiotData) {
-            chrome.runtime.sendMessage({ action: 'auto_refresh_rank' }, () => {});
-          }
-        });
-      } catch (_) {}
     }
     extensionState.initializationInProgress = false;
     extensionState.initializationComplete = true;
   }, 1500);
 }
 
-function setupUrlChangeObserver() {
-  if (window._eloward_url_observer) return;
-  
-  const urlObserver = new MutationObserver(function() {
-    const currentChannel = getCurrentChannelName();
-    const currentPathname = window.location.pathname;
-    
-    if (window.location.pathname.includes('oauth2') || 
-        window.location.pathname.includes('auth/') ||
-        window.location.href.includes('auth/callback') ||
-        window.location.href.includes('auth/redirect')) {
+// Resolves once the new route has settled: the channel can be resolved (VOD pages read it
+// from the DOM) and chat is mounted, or with whatever is known after ROUTE_READY_TIMEOUT_MS.
+// The DomWatch waiter only exists while a navigation is pending, so idle browsing costs nothing.
+const ROUTE_READY_TIMEOUT_MS = 5000;
+
+function waitForRouteReady() {
+  return new Promise((resolve) => {
+    const isReady = () => !!(getCurrentChannelName() && findChatContainer());
+    if (isReady()) {
+      resolve(getCurrentChannelName());
       return;
     }
-    
-    const isVodNow = isVodPage();
-    const wasVodBefore = extensionState.isVod;
-    const pathChanged = extensionState.lastPathname !== currentPathname;
-    
-    if (currentChannel && (currentChannel !== extensionState.channelName || isVodNow !== wasVodBefore || pathChanged)) {
-      if (extensionState.channelName) {
-        cleanupChannel(extensionState.channelName);
+
+    const unwatch = DomWatch.watch({
+      selector: CHAT_READY_SELECTOR,
+      immediate: false,
+      timeout: ROUTE_READY_TIMEOUT_MS,
+      onTimeout: () => resolve(getCurrentChannelName()),
+      callback: () => {
+        if (!isReady()) return;
+        unwatch();
+        resolve(getCurrentChannelName());
       }
-      
-      extensionState.channelName = currentChannel;
-      extensionState.isVod = isVodNow;
-      extensionState.lastPathname = currentPathname;
-      extensionState.initializationComplete = false;
-      
-      // On navigation, only prune unranked entries but preserve ranked users (performance optimization)
-      try { 
-        chrome.runtime.sendMessage({ action: 'prune_unranked_rank_cache' });
-      } catch (_) {}
-      
-      setTimeout(() => {
-        const verifyChannel = getCurrentChannelName();
-        if (verifyChannel === currentChannel) {
-          // If we just entered a VOD page from a channel page, force a fresh init
-          initializeExtension();
-        }
-      }, 750);
-    } else if (!currentChannel && extensionState.channelName) {
-      cleanupChannel(extensionState.channelName);
-      extensionState.channelName = null;
-      extensionState.initializationComplete = false;
-    }
+    });
   });
-  
-  urlObserver.observe(document, { subtree: true, childList: true });
-  window._eloward_url_observer = urlObserver;
 }
 
+let navigationCheckId = 0;
+
+function handleNavigation() {
+  if (engineSuspended) return;
+  if (window.location.pathname.includes('oauth2') || 
+      window.location.pathname.includes('auth/') ||
+      window.location.href.includes('auth/callback') ||
+      window.location.href.includes('auth/redirect')) {
+    return;
+  }
+
+  // Several signals can report the same navigation; only a real path change counts
+  const currentPathname = window.location.pathname;
+  if (currentPathname === extensionState.lastPathname) return;
+  extensionState.lastPathname = currentPathname;
+
+  if (extensionState.channelName) {
+    cleanupChannel(extensionState.channelName);
+    extensionState.channelName = null;
+  }
+  extensionState.initializationComplete = false;
+
+  // On navigation, only prune unranked entries but preserve ranked users (performance optimization)
+  try { 
+    chrome.runtime.sendMessage({ action: 'prune_unranked_rank_cache' });
+  } catch (_) {}
+
+  const checkId = ++navigationCheckId;
+  waitForRouteReady().then((currentChannel) => {
+    // A newer navigation superseded this one
+    if (checkId !== navigationCheckId || !currentChannel) return;
+    extensionState.isVod = isVodPage();
+    initializeExtension();
+  });
+}
+
+// Set while bootstrap.js has the engine unloaded; every entry point that could re-arm
+// observers or timers checks it
+let engineSuspended = false;
+
+// Tear down everything a channel holds: observers, queued work, timers, the rank cache
+// port and viewer tracking. Module state stays so resume() needs no re-injection.
+function suspendEngine() {
+  if (engineSuspended) return;
+  engineSuspended = true;
+  navigationCheckId++; // Drop pending route waits
+  extensionState.currentInitializationId = null; // Pending init timeouts bail out
+
+  if (unwatchChatContainer) {
+    unwatchChatContainer();
+    unwatchChatContainer = null;
+  }
+  cleanupChannel(extensionState.channelName);
+  extensionState.channelName = null;
+  RankCacheMirror.disconnect();
+
+  extensionState.lastPathname = '';
+  extensionState.initializationInProgress = false;
+  extensionState.initializationComplete = false;
+  console.log('💤 EloWard: Chat engine suspended');
+}
+
+function resumeEngine() {
+  if (!engineSuspended) return;
+  engineSuspended = false;
+  handleNavigation(); // lastPathname was reset, so this re-initializes for the current route
+}
+
+// Driven by bootstrap.js, which injects this file once per page and owns navigation events
+const EloWardEngine = {
+  navigate: handleNavigation,
+  suspend: suspendEngine,
+  resume: resumeEngine
+};
+
 function findChatContainer() {
-  
-  const selectors = [
-    '.chat-scrollable-area__message-container',
-    '[data-a-target="chat-scroller"]',
-    '.chat-list--default',
-    '.chat-list',
-    '.simplebar-content',
-    '[data-test-selector="chat-scrollable-area__message-container"]',
-    '.chat-room__content .simplebar-content',
-    '.ffz-chat-container',
-    '.seventv-chat-container',
-    // VOD-specific candidates
-    '[data-test-selector="video-chat__message-list"]',
-    '.video-chat__message-list',
-    '.video-chat__message-list-wrapper',
-    '[data-a-target="video-chat"] .simplebar-content',
-    '[data-a-target="video-chat"] [role="log"]'
-  ];
-  
-  for (const selector of selectors) {
+  for (const selector of CHAT_CONTAINER_SELECTORS) {
     const container = document.querySelector(selector);
     if (container) return container;
   }
   
-  const anyMessage = document.querySelector('.chat-line__message, .chat-line, [data-a-target="chat-line-message"], .video-chat__message, [data-test-selector*="chat-message"]');
+  const anyMessage = document.querySelector(ANY_CHAT_MESSAGE_SELECTOR);
   if (anyMessage) {
     const container = anyMessage.closest('[role="log"], [class*="scroll"], [data-a-target="video-chat"]') || anyMessage.parentElement;
     if (container) return container;
@@ -1412,115 +2002,353 @@ function findChatContainer() {
   return null;
 }
 
+let unwatchChatContainer = null;
+
 function initializeObserver() {
   if (extensionState.observerInitialized) return;
+  if (unwatchChatContainer) unwatchChatContainer();
   
-  let attempts = 0;
-  const maxAttempts = 5;
-  
-  function tryInitialize() {
-    const chatContainer = findChatContainer();
-    
-    if (chatContainer) {
-      setupChatObserver(chatContainer);
-      extensionState.observerInitialized = true;
+  // Chat usually mounts within a few seconds of the route; stop waiting after 10s
+  unwatchChatContainer = whenChatContainerReady((chatContainer) => {
+    unwatchChatContainer = null;
+    if (extensionState.observerInitialized) return;
+    setupChatObserver(chatContainer);
+    extensionState.observerInitialized = true;
+  }, 10000);
+}
+
+// Messages are only resolved once they are in or near the visible part of the chat scroller
+// (the IntersectionObserver root, so rootMargin applies inside the scrolling chat). Past
+// MAX_DEFERRED waiting messages the oldest stop being observed, so a long backlog or a VOD
+// seek costs what is on screen rather than the whole history; they are set aside rather than
+// dropped, and a scroll that brings one back into view still resolves it.
+const MessageVisibility = (() => {
+  const MAX_DEFERRED = 300;
+  const ROOT_MARGIN_PX = 200;
+  const deferred = new Map(); // message -> handler, in arrival order
+  let evicted = new WeakMap(); // message -> handler, no longer observed
+  let evictedCount = 0;
+  let root = null; // chat scroll container; null means the viewport
+  let observer = null;
+  let scrollCheckQueued = false;
+
+  function getObserver() {
+    if (!observer) {
+      observer = new IntersectionObserver(onIntersect, { root, rootMargin: `${ROOT_MARGIN_PX}px 0px` });
+    }
+    return observer;
+  }
+
+  // Nearest scrollable ancestor of the chat list, found once per chat setup
+  function findScrollRoot(element) {
+    for (let node = element; node && node !== document.body; node = node.parentElement) {
+      const overflowY = getComputedStyle(node).overflowY;
+      if (overflowY === 'auto' || overflowY === 'scroll') return node;
+    }
+    return null;
+  }
+
+  function setRoot(chatContainer) {
+    const nextRoot = findScrollRoot(chatContainer);
+    if (nextRoot === root) return;
+    root = nextRoot;
+    // Re-observe what is waiting under the new root
+    if (observer) {
+      observer.disconnect();
+      observer = null;
+      for (const message of deferred.keys()) getObserver().observe(message);
+    }
+  }
+
+  function onIntersect(entries) {
+    const batches = new Map(); // handler -> visible messages
+    for (const entry of entries) {
+      const message = entry.target;
+      const handler = deferred.get(message);
+      if (!handler) continue;
+      if (!message.isConnected) {
+        drop(message);
+        continue;
+      }
+      if (!entry.isIntersecting) continue;
+
+      drop(message);
+      if (!batches.has(handler)) batches.set(handler, []);
+      batches.get(handler).push(message);
+    }
+    runBatches(batches);
+  }
+
+  function runBatches(batches) {
+    for (const [handler, messages] of batches) {
+      try { handler(messages); } catch (_) {}
+    }
+  }
+
+  // Set-aside messages scrolled back into range are resolved like any visible message
+  function onScroll() {
+    if (evictedCount === 0 || scrollCheckQueued) return;
+    scrollCheckQueued = true;
+    requestAnimationFrame(() => {
+      scrollCheckQueued = false;
+      if (evictedCount === 0) return;
+      const bounds = root ? root.getBoundingClientRect() : { top: 0, bottom: window.innerHeight };
+      const top = bounds.top - ROOT_MARGIN_PX;
+      const bottom = bounds.bottom + ROOT_MARGIN_PX;
+      const batches = new Map();
+      for (const message of (root || document).querySelectorAll(getCompiledSelectors().message)) {
+        const handler = evicted.get(message);
+        if (!handler) continue;
+        const rect = message.getBoundingClientRect();
+        if (rect.bottom < top || rect.top > bottom) continue;
+        evicted.delete(message);
+        evictedCount--;
+        if (!batches.has(handler)) batches.set(handler, []);
+        batches.get(handler).push(message);
+      }
+      runBatches(batches);
+    });
+  }
+
+  function defer(message, handler) {
+    if (typeof IntersectionObserver === 'undefined') {
+      handler([message]);
+      return;
+    }
+    if (deferred.has(message) || evicted.has(message)) return;
+
+    deferred.set(message, handler);
+    getObserver().observe(message);
+
+    while (deferred.size > MAX_DEFERRED) {
+      const oldest = deferred.keys().next().value;
+      const oldestHandler = deferred.get(oldest);
+      drop(oldest);
+      evicted.set(oldest, oldestHandler);
+      evictedCount++;
+    }
+  }
+
+  function drop(message) {
+    deferred.delete(message);
+    if (observer) observer.unobserve(message);
+  }
+
+  function clear() {
+    if (observer) observer.disconnect();
+    observer = null;
+    root = null;
+    deferred.clear();
+    evicted = new WeakMap();
+    evictedCount = 0;
+  }
+
+  // Scroll doesn't bubble, so capture it from whichever element scrolls the chat
+  document.addEventListener('scroll', onScroll, { capture: true, passive: true });
+
+  return { defer, setRoot, clear };
+})();
+
+// Rank work is queued per chatter, not per message: a flood from one user is one task that
+// badges every pending message of theirs
+const pendingRankTargets = new Map(); // username -> Set of username elements awaiting that rank
+
+function processVisibleNewMessages(messages) {
+  for (const message of messages) {
+    const target = claimNewMessage(message);
+    if (!target) continue;
+    let elements = pendingRankTargets.get(target.username);
+    if (!elements) {
+      elements = new Set();
+      pendingRankTargets.set(target.username, elements);
+    }
+    elements.add(target.usernameElement);
+    ChatScheduler.enqueue(`user:${target.username}`, () => resolveRankForUser(target.username));
+  }
+}
+
+function deferNewMessage(message) {
+  if (!message || processedMessages.has(message)) return;
+  MessageVisibility.defer(message, processVisibleNewMessages);
+}
+
+// Cooperative scheduler for chat work. Tasks are keyed so re-queuing the same key collapses
+// into one pending task, and drained in slices of at most CHAT_SLICE_BUDGET_MS using
+// scheduler.postTask, requestIdleCallback or a timer, whichever the browser has. Past
+// CHAT_QUEUE_LIMIT pending tasks the oldest droppable ones are discarded.
+const CHAT_SLICE_BUDGET_MS = 5;
+const CHAT_QUEUE_LIMIT = 1000;
+
+const ChatScheduler = (() => {
+  const queue = new Map(); // key -> { run, droppable }
+  let drainHandle = null;
+  let paused = false;
+  const stats = { depth: 0, maxDepth: 0, processed: 0, collapsed: 0, dropped: 0, slices: 0 };
+
+  function enqueue(key, run, droppable = true) {
+    if (queue.has(key)) {
+      stats.collapsed++;
+      return;
+    }
+    queue.set(key, { run, droppable });
+
+    if (queue.size > CHAT_QUEUE_LIMIT) {
+      for (const [queuedKey, task] of queue) {
+        if (!task.droppable) continue;
+        queue.delete(queuedKey);
+        stats.dropped++;
+        break;
+      }
+    }
+
+    stats.depth = queue.size;
+    if (queue.size > stats.maxDepth) stats.maxDepth = queue.size;
+    schedule();
+  }
+
+  function schedule() {
+    if (drainHandle || paused) return;
+    if (globalThis.scheduler && typeof globalThis.scheduler.postTask === 'function') {
+      const controller = new AbortController();
+      drainHandle = { controller };
+      globalThis.scheduler.postTask(() => drain(null), { priority: 'user-visible', signal: controller.signal }).catch(() => {});
+    } else if (typeof requestIdleCallback === 'function') {
+      drainHandle = { idle: requestIdleCallback(drain, { timeout: 100 }) };
     } else {
-      attempts++;
-      if (attempts < maxAttempts) {
-        setTimeout(tryInitialize, attempts * 1000);
+      drainHandle = { timeout: setTimeout(() => drain(null), 0) };
+    }
+  }
+
+  function drain(idleDeadline) {
+    drainHandle = null;
+    stats.slices++;
+    const sliceStart = performance.now();
+
+    for (const [key, task] of queue) {
+      if (paused) break;
+      const outOfTime = idleDeadline && !idleDeadline.didTimeout
+        ? idleDeadline.timeRemaining() < 1
+        : performance.now() - sliceStart >= CHAT_SLICE_BUDGET_MS;
+      if (outOfTime) break;
+
+      queue.delete(key);
+      const metricsStart = EloWardMetrics.start();
+      try { task.run(); } catch (_) {}
+      EloWardMetrics.end('chat.task_ms', metricsStart);
+      stats.processed++;
+    }
+
+    stats.depth = queue.size;
+    if (queue.size > 0) schedule();
+  }
+
+  function clear() {
+    if (drainHandle) {
+      if (drainHandle.controller) drainHandle.controller.abort();
+      if (drainHandle.idle) cancelIdleCallback(drainHandle.idle);
+      if (drainHandle.timeout) clearTimeout(drainHandle.timeout);
+      drainHandle = null;
+    }
+    queue.clear();
+    pendingRankTargets.clear();
+    stats.depth = 0;
+  }
+
+  // Hidden tabs keep queueing (oldest droppable work still gets dropped) but run nothing
+  function setPaused(value) {
+    paused = !!value;
+    if (!paused && queue.size > 0) schedule();
+  }
+
+  return { enqueue, clear, setPaused, stats };
+})();
+
+extensionState.chatSchedulerStats = ChatScheduler.stats;
+
+ChatScheduler.setPaused(document.visibilityState === 'hidden');
+document.addEventListener('visibilitychange', () => {
+  ChatScheduler.setPaused(document.visibilityState === 'hidden');
+});
+
+// Scan one node added to chat for messages; runs as a scheduler task
+function scanAddedChatNode(node) {
+  if (!extensionState.isChannelActive || !node.isConnected) return;
+
+  const messageSelector = getCompiledSelectors().message;
+
+  // VOD chat can render message wrapper (dtSdDz) where the actual message is inside .video-chat__message
+  if (isVodPage() && node.matches(VOD_MESSAGE_WRAPPER_SELECTOR)) {
+    // Collect inner messages for both standard VOD and 7TV VOD
+    const innerMsgs = node.querySelectorAll(VOD_INNER_MESSAGE_SELECTOR);
+    const author = node.querySelector('a.video-chat__message-author');
+    if (author || innerMsgs.length) {
+      const messages = innerMsgs.length ? innerMsgs : node.querySelectorAll(messageSelector);
+      if (messages.length) {
+        // Ensure we re-evaluate username on VOD for wrappers
+        messages.forEach(m => deferNewMessage(m));
+        return;
       }
     }
   }
-  
-  tryInitialize();
+
+  if (node.matches(messageSelector)) {
+    deferNewMessage(node);
+  } else {
+    for (const message of node.querySelectorAll(messageSelector)) {
+      deferNewMessage(message);
+    }
+  }
 }
 
 function setupChatObserver(chatContainer) {
-  const currentSelectors = SELECTORS[extensionState.chatMode];
-  const messageSelectors = currentSelectors.message;
-  
-  
+  const messageSelector = getCompiledSelectors().message;
 
+  BadgeTooltips.attach(chatContainer);
+  MessageVisibility.setRoot(chatContainer);
 
-  processExistingMessages(chatContainer, messageSelectors);
-  
-  const chatObserver = new MutationObserver((mutations) => {
-    if (!extensionState.isChannelActive) return;
-    
-    try {
-      for (const mutation of mutations) {
-        if (mutation.type === 'childList' && mutation.addedNodes.length > 0) {
-          
-          for (const node of mutation.addedNodes) {
-            if (node.nodeType === Node.ELEMENT_NODE) {
-              // VOD chat can render message wrapper (dtSdDz) where the actual message is inside .video-chat__message
-              if (isVodPage() && (node.matches && node.matches('.dtSdDz, .vod-message, .seventv-user-message, .seventv-chat-vod-message-patched'))) {
-                // Collect inner messages for both standard VOD and 7TV VOD
-                const innerMsgs = node.querySelectorAll('.video-chat__message, .seventv-user-message');
-                const author = node.querySelector('a.video-chat__message-author');
-                if (author || innerMsgs.length) {
-                  const messages = innerMsgs.length ? innerMsgs : node.querySelectorAll(messageSelectors.join(', '));
-                  if (messages && messages.length) {
-                    
-                    messages.forEach(m => {
-                      // Ensure we re-evaluate username on VOD for wrappers
-                      processNewMessage(m);
-                    });
-                    continue;
-                  }
-                }
-              }
-              const isMessage = messageSelectors.some(selector => 
-                node.matches && node.matches(selector)
-              );
-              
-              if (isMessage) {
-                
-                processNewMessage(node);
-              } else {
-                const messages = node.querySelectorAll(messageSelectors.join(', '));
-                
-                for (const message of messages) {
-                  
-                  processNewMessage(message);
-                }
-              }
-            }
-          }
-        }
-      }
-    } catch (error) {}
-  });
+  processExistingMessages(chatContainer, messageSelector);
   
-  chatObserver.observe(chatContainer, {
-    childList: true,
-    subtree: true,
-    attributes: true,
-    attributeFilter: ['class', 'style']
+  // Only added nodes that are or contain messages are queued; scanning happens in scheduler slices
+  const unwatchChat = DomWatch.watch({
+    root: chatContainer,
+    selector: `${messageSelector}, ${VOD_MESSAGE_WRAPPER_SELECTOR}`,
+    immediate: false,
+    callback: (_match, node) => {
+      if (!extensionState.isChannelActive) return;
+      ChatScheduler.enqueue(node, () => scanAddedChatNode(node));
+    }
   });
   
-  window._eloward_chat_observer = chatObserver;
+  window._eloward_chat_observer = { disconnect: unwatchChat };
   
   setTimeout(() => {
     try {
-      processExistingMessages(chatContainer, messageSelectors);
+      processExistingMessages(chatContainer, getCompiledSelectors().message);
     } catch (error) {
       // Silent error handling for production
     }
   }, 3000);
 }
 
-function processExistingMessages(chatContainer, messageSelectors) {
+function processExistingMessages(chatContainer, messageSelector) {
   try {
-  const existingMessages = chatContainer.querySelectorAll(messageSelectors.join(', '));
-    const currentSelectors = SELECTORS[extensionState.chatMode];
-    const usernameSelectors = currentSelectors.username;
-    
-    
+    // The backlog waits for visibility; resolved messages are batched per intersection callback
+    for (const message of chatContainer.querySelectorAll(messageSelector)) {
+      if (processedMessages.has(message)) continue;
+      MessageVisibility.defer(message, resolveMessageBatch);
+    }
+  } catch (error) {
+    // Silent error handling for production
+  }
+}
 
+function resolveMessageBatch(messages) {
+  if (!extensionState.isChannelActive) return;
+  try {
+    const usernameSelectors = getCompiledSelectors().username;
     const userMessageMap = new Map();
     
-    for (const message of existingMessages) {
+    for (const message of messages) {
       if (processedMessages.has(message)) continue;
       
 
@@ -1543,9 +2371,8 @@ function processExistingMessages(chatContainer, messageSelectors) {
       if (message.querySelector('.eloward-rank-badge')) continue;
       
       processedMessages.add(message);
-      // Track pending badge target for immediate application on fetch
-      if (!pendingBadgeTargets.has(username)) pendingBadgeTargets.set(username, new Set());
-      pendingBadgeTargets.get(username).add(usernameElement);
+      // Track badge target so later rank updates reach this message directly
+      BadgeTargets.register(username, usernameElement);
       
       if (!userMessageMap.has(username)) {
         userMessageMap.set(username, []);
@@ -1567,53 +2394,208 @@ function processExistingMessages(chatContainer, messageSelectors) {
 
 
 
+// Read-through mirror of the background rank cache, fed over a long-lived port.
+// Values are rank data for ranked users and null for users known to have no rank.
+// The snapshot covers this channel's known viewers and the most-used entries only; users
+// outside it are looked up on a miss and remembered from the answer.
+// Stale values are still served; reading one asks the background to refresh it, and the
+// refreshed rank arrives as a delta that is re-applied to that user's visible messages.
+const RankCacheMirror = (() => {
+  const PORT_NAME = 'eloward_rank_cache';
+  const entries = new Map();
+  const staleAt = new Map();
+  const revalidationRequested = new Set();
+  let pendingRevalidation = new Set();
+  let revalidationTimer = null;
+  let port = null;
+  let ready = false;
+
+  function handleMessage(message) {
+    if (!message) return;
+    EloWardMetrics.count(`ipc.port.${message.type}`);
+    if (message.type === 'rank_cache_snapshot') {
+      entries.clear();
+      staleAt.clear();
+      revalidationRequested.clear();
+      for (const [username, rankData] of Object.entries(message.ranks || {})) {
+        entries.set(username, rankData);
+      }
+      for (const [username, deadline] of Object.entries(message.staleAt || {})) {
+        staleAt.set(username, deadline);
+      }
+      ready = true;
+    } else if (message.type === 'rank_cache_delta') {
+      const deadlines = message.staleAt || {};
+      for (const [username, rankData] of Object.entries(message.set || {})) {
+        const previous = entries.get(username);
+        entries.set(username, rankData);
+        if (deadlines[username]) staleAt.set(username, deadlines[username]);
+        if (!(staleAt.get(username) <= Date.now())) revalidationRequested.delete(username);
+        // Badges already show an unchanged rank
+        if (rankData && (!previous || BadgeTargets.signatureOf(previous) !== BadgeTargets.signatureOf(rankData))) {
+          applyRankToAllUserMessagesInChat(username, rankData);
+        }
+      }
+      for (const username of message.removed || []) {
+        entries.delete(username);
+        staleAt.delete(username);
+        revalidationRequested.delete(username);
+      }
+    } else if (message.type === 'rank_cache_stale') {
+      // Same rule the background applied in markStale; ranks are untouched, only their deadline
+      for (const [username, rankData] of entries) {
+        if (username === message.except) continue;
+        if (message.lowSignalOnly && rankData && rankData.tier && String(rankData.tier).toUpperCase() !== 'UNRANKED') continue;
+        if ((staleAt.get(username) || Infinity) <= message.at) continue;
+        staleAt.set(username, message.at);
+        revalidationRequested.delete(username);
+      }
+    }
+  }
+
+  function requestRevalidation(username) {
+    if (revalidationRequested.has(username)) return;
+    revalidationRequested.add(username);
+    pendingRevalidation.add(username);
+    if (revalidationTimer) return;
+    revalidationTimer = setTimeout(() => {
+      revalidationTimer = null;
+      const usernames = Array.from(pendingRevalidation);
+      pendingRevalidation = new Set();
+      try {
+        chrome.runtime.sendMessage({ action: 'revalidate_ranks', usernames }, () => {
+          void chrome.runtime.lastError;
+        });
+      } catch (_) {}
+    }, 0);
+  }
+
+  function get(username) {
+    if ((staleAt.get(username) || Infinity) <= Date.now()) requestRevalidation(username);
+    EloWardMetrics.count(entries.has(username) ? 'mirror.hit' : 'mirror.miss');
+    return entries.get(username);
+  }
+
+  // (Re)names this tab's channel; the background answers with a snapshot scoped to it
+  function subscribe(channel) {
+    if (!port) return;
+    try { port.postMessage({ type: 'rank_cache_subscribe', channel: channel || null }); } catch (_) {}
+  }
+
+  // Reconnect lazily on the next lookup so an idle tab doesn't keep the service worker awake
+  function ensureConnected() {
+    if (port) return;
+    try {
+      port = chrome.runtime.connect({ name: PORT_NAME });
+      port.onMessage.addListener(handleMessage);
+      subscribe(extensionState.channelName);
+      port.onDisconnect.addListener(() => {
+        void chrome.runtime.lastError;
+        port = null;
+        ready = false;
+        entries.clear();
+        staleAt.clear();
+        revalidationRequested.clear();
+      });
+    } catch (_) {
+      port = null;
+    }
+  }
+
+  // Keep a looked-up rank so later messages from the user skip the round trip; deltas update it
+  function remember(username, rankData) {
+    if (!ready || !username) return;
+    entries.set(username, rankData || null);
+  }
+
+  function disconnect() {
+    if (!port) return;
+    try { port.disconnect(); } catch (_) {}
+    port = null;
+    ready = false;
+    entries.clear();
+    staleAt.clear();
+    revalidationRequested.clear();
+  }
+
+  return {
+    ensureConnected,
+    disconnect,
+    isReady: () => ready,
+    has: (username) => ready && entries.has(username),
+    get,
+    remember,
+    subscribe
+  };
+})();
+
 function processUsernamesBatch(userMessageMap) {
   try {
-    
-    chrome.runtime.sendMessage({ action: 'get_all_cached_ranks' }, (response) => {
-      const cachedRanks = response?.ranks || {};
-      const usersNeedingFetch = new Set();
-      
+    RankCacheMirror.ensureConnected();
 
-      for (const [username, messageData] of userMessageMap.entries()) {
+    if (RankCacheMirror.isReady()) {
+      resolveUsernamesFromCache(userMessageMap, (username) => RankCacheMirror.get(username), (username) => RankCacheMirror.has(username));
+      return;
+    }
 
-        if (extensionState.currentUser && username === extensionState.currentUser) {
-          handleCurrentUserMessages(messageData);
-          continue;
-        }
-        
-        if (cachedRanks[username]) {
-
-          applyRankToAllUserMessages(username, messageData, cachedRanks[username]);
-          
-
-          if (extensionState.channelName) {
-            chrome.runtime.sendMessage({
-              action: 'increment_db_reads',
-              channel: extensionState.channelName
-            });
-            chrome.runtime.sendMessage({
-              action: 'increment_successful_lookups',
-              channel: extensionState.channelName
-            });
-          }
-        } else {
-          usersNeedingFetch.add(username);
-        }
-      }
-      
-      
-      if (usersNeedingFetch.size > 0) {
-        fetchRanksForUsers(usersNeedingFetch, userMessageMap);
-      }
+    // Mirror not synced yet: fall back to a one-off copy of the background cache
+    chrome.runtime.sendMessage({ action: 'get_all_cached_ranks', usernames: Array.from(userMessageMap.keys()) }, (response) => {
+      const cachedRanks = response?.ranks || {};
+      resolveUsernamesFromCache(userMessageMap, (username) => cachedRanks[username], (username) => !!cachedRanks[username]);
     });
   } catch (error) {
     // Silent error handling for production
   }
 }
 
+function resolveUsernamesFromCache(userMessageMap, getCachedRank, isCached) {
+  const usersNeedingFetch = new Set();
+
+  for (const [username, messageData] of userMessageMap.entries()) {
+
+    if (extensionState.currentUser && username === extensionState.currentUser) {
+      handleCurrentUserMessages(messageData);
+      continue;
+    }
+
+    if (!isCached(username)) {
+      usersNeedingFetch.add(username);
+      continue;
+    }
+
+    // Known unranked users are cached as null and need no lookup
+    const cachedRank = getCachedRank(username);
+    if (!cachedRank) continue;
+
+    applyRankToAllUserMessages(username, messageData, cachedRank);
+
+    EloWardMetrics.count('lookups.db_reads');
+    EloWardMetrics.count('lookups.successful');
+  }
+
+  if (usersNeedingFetch.size > 0) {
+    fetchRanksForUsers(usersNeedingFetch, userMessageMap);
+  }
+}
+
+// The background refreshes the local user's rank only while they chat (rankRefreshScheduler)
+const CHAT_ACTIVITY_REPORT_INTERVAL_MS = 60 * 1000;
+let lastChatActivityReportAt = 0;
+
+function reportLocalUserChatActivity() {
+  const now = Date.now();
+  if (now - lastChatActivityReportAt < CHAT_ACTIVITY_REPORT_INTERVAL_MS) return;
+  lastChatActivityReportAt = now;
+  try {
+    chrome.runtime.sendMessage({ action: 'local_user_chat_activity' }, () => {
+      void chrome.runtime.lastError;
+    });
+  } catch (_) {}
+}
+
 function handleCurrentUserMessages(messageData) {
-  chrome.storage.local.get(['eloward_persistent_riot_user_data', 'eloward_user_options'], (data) => {
+  reportLocalUserChatActivity();
+  EloWardStorage.get(['eloward_persistent_riot_user_data', 'eloward_user_options']).then((data) => {
     const riotData = data.eloward_persistent_riot_user_data;
     const userOptions = data.eloward_user_options || {};
     
@@ -1647,16 +2629,8 @@ function handleCurrentUserMessages(messageData) {
     });
 
     
-    if (extensionState.channelName) {
-      chrome.runtime.sendMessage({
-        action: 'increment_db_reads',
-        channel: extensionState.channelName
-      });
-      chrome.runtime.sendMessage({
-        action: 'increment_successful_lookups',
-        channel: extensionState.channelName
-      });
-    }
+    EloWardMetrics.count('lookups.db_reads');
+    EloWardMetrics.count('lookups.successful');
   });
 }
 
@@ -1667,53 +2641,41 @@ function applyRankToAllUserMessages(username, messageData, rankData) {
 }
 
 function fetchRanksForUsers(usersNeedingFetch, userMessageMap) {
-  // Fetch ranks for each user (could be optimized further with a batch API endpoint)
-  for (const username of usersNeedingFetch) {
-    const messageData = userMessageMap.get(username);
-    
-    if (extensionState.channelName) {
-      chrome.runtime.sendMessage({
-        action: 'increment_db_reads',
-        channel: extensionState.channelName
-      });
-    }
+  // Resolve all uncached users with one message; the background coalesces them into batch requests
+  const usernames = Array.from(usersNeedingFetch);
 
-    chrome.runtime.sendMessage({
-      action: 'fetch_rank_for_username',
-      username: username,
-      channel: extensionState.channelName
-    }, (response) => {
-      if (chrome.runtime.lastError) return;
-      
-      if (response?.success && response.rankData) {
-        // Apply rank to ALL messages for this user at once
-        applyRankToAllUserMessages(username, messageData, response.rankData);
-        
-        if (extensionState.channelName) {
-          chrome.runtime.sendMessage({
-            action: 'increment_successful_lookups',
-            channel: extensionState.channelName
-          });
-        }
-      }
-    });
-  }
+  EloWardMetrics.count('lookups.db_reads', usernames.length);
+
+  chrome.runtime.sendMessage({
+    action: 'fetch_ranks_for_usernames',
+    usernames: usernames,
+    channel: extensionState.channelName
+  }, (response) => {
+    if (chrome.runtime.lastError) return;
+    if (!response?.success || !response.ranks) return;
+
+    for (const username of usernames) {
+      const rankData = response.ranks[username];
+      if (username in response.ranks) RankCacheMirror.remember(username, rankData);
+      if (!rankData) continue;
+
+      // Apply rank to ALL messages for this user at once
+      applyRankToAllUserMessages(username, userMessageMap.get(username), rankData);
+
+      EloWardMetrics.count('lookups.successful');
+    }
+  });
 }
 
-function processNewMessage(messageNode) {
-  if (!messageNode || processedMessages.has(messageNode)) return;
-  if (!extensionState.isChannelActive) return;
+// Mark a new message processed and find its author; null when it has none
+function claimNewMessage(messageNode) {
+  if (!messageNode || processedMessages.has(messageNode)) return null;
+  if (!extensionState.isChannelActive) return null;
   
   processedMessages.add(messageNode);
-  
-  if (processedMessages.size > 500) {
-    const toDelete = Array.from(processedMessages).slice(0, 100);
-    toDelete.forEach(msg => processedMessages.delete(msg));
-  }
 
   try {
-    const currentSelectors = SELECTORS[extensionState.chatMode];
-    const usernameSelectors = currentSelectors.username;
+    const usernameSelectors = getCompiledSelectors().username;
     
     let usernameElement = null;
     for (const selector of usernameSelectors) {
@@ -1733,10 +2695,10 @@ function processNewMessage(messageNode) {
         if (info.el) usernameElement = info.el;
         if (!usernameElement) {
           console.log('📼 EloWard (VOD): New message without username element', messageNode);
-          return;
+          return null;
         }
       } else {
-        return;
+        return null;
       }
     }
     
@@ -1745,11 +2707,28 @@ function processNewMessage(messageNode) {
       if (isVodPage()) {
         console.log('📼 EloWard (VOD): New message username empty', usernameElement);
       }
-      return;
+      return null;
     }
     
+    // Every chat username element is indexed so resolved or updated ranks reach it directly
+    BadgeTargets.register(username, usernameElement);
+    return { username, usernameElement };
+  } catch (error) {
+    console.error('EloWard: Error processing message:', error);
+    return null;
+  }
+}
+
+// Scheduler task for one chatter: resolve the rank once and badge all their pending messages
+function resolveRankForUser(username) {
+  const elements = Array.from(pendingRankTargets.get(username) || []).filter(element => element.isConnected);
+  pendingRankTargets.delete(username);
+  if (elements.length === 0 || !extensionState.isChannelActive) return;
+
+  try {
     if (extensionState.currentUser && username === extensionState.currentUser) {
-      chrome.storage.local.get(['eloward_persistent_riot_user_data', 'eloward_user_options'], (data) => {
+      reportLocalUserChatActivity();
+      EloWardStorage.get(['eloward_persistent_riot_user_data', 'eloward_user_options']).then((data) => {
         const riotData = data.eloward_persistent_riot_user_data;
         const userOptions = data.eloward_user_options || {};
         
@@ -1779,106 +2758,145 @@ function processNewMessage(messageNode) {
         });
 
         
-        if (extensionState.channelName) {
-          chrome.runtime.sendMessage({
-            action: 'increment_db_reads',
-            channel: extensionState.channelName
-          });
-          
-          chrome.runtime.sendMessage({
-            action: 'increment_successful_lookups',
-            channel: extensionState.channelName
-          });
-        }
+        EloWardMetrics.count('lookups.db_reads');
+        EloWardMetrics.count('lookups.successful');
         
-        addBadgeToMessage(usernameElement, userRankData);
+        elements.forEach(element => addBadgeToMessage(element, userRankData));
       });
       return;
     }
     
-    // Register this username element as a pending target for when rank data arrives
-    if (!pendingBadgeTargets.has(username)) pendingBadgeTargets.set(username, new Set());
-    pendingBadgeTargets.get(username).add(usernameElement);
+    // Served straight from the mirrored cache when the background already knows this user
+    RankCacheMirror.ensureConnected();
+    if (RankCacheMirror.has(username)) {
+      const cachedRank = RankCacheMirror.get(username);
+      if (cachedRank) {
+        elements.forEach(element => addBadgeToMessage(element, cachedRank));
+        EloWardMetrics.count('lookups.db_reads');
+        EloWardMetrics.count('lookups.successful');
+      }
+      return;
+    }
+
     fetchRankFromBackground(username);
   } catch (error) {
-    console.error('EloWard: Error processing message:', error);
+    console.error('EloWard: Error resolving rank for chatter:', error);
   }
 }
 
+// Lookups queued during a drain go out together as one fetch_ranks_for_usernames message.
+// A username already queued or awaiting a response is not requested again; the badge
+// registry applies the eventual result to every message from that user.
+const queuedRankLookups = new Set();
+const inFlightRankLookups = new Set();
+
 function fetchRankFromBackground(username) {
-  if (extensionState.channelName) {
-    chrome.runtime.sendMessage({
-      action: 'increment_db_reads',
-      channel: extensionState.channelName
-    });
+  if (queuedRankLookups.has(username) || inFlightRankLookups.has(username)) {
+    ChatScheduler.stats.collapsed++;
+    return;
   }
+  queuedRankLookups.add(username);
+  // Never dropped: it carries every queued username
+  ChatScheduler.enqueue('rank-lookups', flushQueuedRankLookups, false);
+}
+
+function flushQueuedRankLookups() {
+  const usernames = Array.from(queuedRankLookups);
+  queuedRankLookups.clear();
+  if (usernames.length === 0) return;
+  usernames.forEach(username => inFlightRankLookups.add(username));
+
+  EloWardMetrics.count('lookups.db_reads', usernames.length);
+  EloWardMetrics.count('ipc.out.fetch_ranks_for_usernames');
+  const metricsStart = EloWardMetrics.start();
 
   chrome.runtime.sendMessage({
-    action: 'fetch_rank_for_username',
-    username: username,
+    action: 'fetch_ranks_for_usernames',
+    usernames: usernames,
     channel: extensionState.channelName
   }, (response) => {
+    EloWardMetrics.end('ipc.fetch_ranks_roundtrip_ms', metricsStart);
+    usernames.forEach(username => inFlightRankLookups.delete(username));
     if (chrome.runtime.lastError) return;
-    
-    if (response?.success && response.rankData) {
-      if (extensionState.channelName) {
-        chrome.runtime.sendMessage({
-          action: 'increment_successful_lookups',
-          channel: extensionState.channelName
-        });
-      }
+    if (!response?.success || !response.ranks) return;
+
+    for (const username of usernames) {
+      const rankData = response.ranks[username];
+      if (!rankData) continue;
+
+      EloWardMetrics.count('lookups.successful');
 
       // Apply the rank to ALL messages from this user in the chat
-      applyRankToAllUserMessagesInChat(username, response.rankData);
+      applyRankToAllUserMessagesInChat(username, rankData);
     }
   });
 }
 
 function applyRankToAllUserMessagesInChat(username, rankData) {
+  if (!rankData?.tier) return;
   try {
-    // 1) Apply to any pending specific username elements queued during observation
-    const targets = pendingBadgeTargets.get(username);
-    if (targets && targets.size) {
-      targets.forEach((el) => {
-        if (el && el.isConnected) addBadgeToMessage(el, rankData);
-      });
-      pendingBadgeTargets.delete(username);
-    }
-    
-    // 2) Also sweep the visible chat for this username (covers initial scan and missed nodes)
-    const currentSelectors = SELECTORS[extensionState.chatMode];
-    const messageSelectors = currentSelectors.message;
-    const usernameSelectors = currentSelectors.username;
-    const allMessages = document.querySelectorAll(messageSelectors.join(', '));
-    
-    allMessages.forEach(messageElement => {
-      if (messageElement.querySelector('.eloward-rank-badge')) return;
-      let usernameElement = null;
-      for (const selector of usernameSelectors) {
-        usernameElement = messageElement.querySelector(selector);
-        if (usernameElement) break;
-      }
-      if (!usernameElement && isVodPage()) {
-        const info = findVodUsernameInfo(messageElement);
-        if (info.el) usernameElement = info.el;
-      }
-      if (!usernameElement) return;
-      const messageUsername = (((usernameElement.getAttribute && usernameElement.getAttribute('data-a-user')) || usernameElement.textContent) || '').trim().toLowerCase();
-      if (messageUsername === username) {
-        addBadgeToMessage(usernameElement, rankData);
-      }
+    // Registered elements only; ones already showing this exact rank are left alone
+    BadgeTargets.forEach(username, (usernameElement) => {
+      if (BadgeTargets.hasApplied(usernameElement, rankData)) return;
+      addBadgeToMessage(usernameElement, rankData);
     });
   } catch (error) {
     console.error('EloWard: Error applying rank to all user messages:', error);
   }
 }
 
+// Chat-mode specific badge placement lives in js/content/adapters and is imported once the
+// mode is known, so standard live chat never parses the 7TV, FFZ or VOD paths
+const BadgeAdapters = (() => {
+  const MODULE_PATHS = {
+    seventv: 'js/content/adapters/seventv.js',
+    ffz: 'js/content/adapters/ffz.js',
+    vod: 'js/content/adapters/vod.js'
+  };
+  const adapters = new Map(); // name -> adapter
+  const loading = new Map(); // name -> Promise<adapter|null>
+
+  function nameFor(chatMode, isVod) {
+    if (chatMode === 'seventv' || chatMode === 'ffz') return chatMode;
+    return isVod ? 'vod' : null;
+  }
+
+  function load(name) {
+    if (!MODULE_PATHS[name]) return Promise.resolve(null);
+    if (!loading.has(name)) {
+      const pending = import(chrome.runtime.getURL(MODULE_PATHS[name]))
+        .then((module) => {
+          const adapter = module.createAdapter({ BadgeRenderer, updateBadgeElement, findBadgeContainer });
+          adapters.set(name, adapter);
+          return adapter;
+        })
+        .catch((error) => {
+          console.warn(`EloWard: Failed to load ${name} badge adapter`, error);
+          loading.delete(name); // Retry on the next badge
+          return null;
+        });
+      loading.set(name, pending);
+    }
+    return loading.get(name);
+  }
+
+  function get(name) {
+    return adapters.get(name) || null;
+  }
+
+  return { nameFor, load, get };
+})();
+
 function addBadgeToMessage(usernameElement, rankData) {
-  if (!rankData?.tier) return;
-  
+  if (!rankData?.tier || !usernameElement) return;
+
+  BadgeTargets.noteApplied(usernameElement, rankData);
+  BadgeRenderer.enqueue(usernameElement, rankData);
+}
+
+function renderBadge(usernameElement, rankData) {
   try {
-    const currentSelectors = SELECTORS[extensionState.chatMode];
-    const messageContainer = usernameElement.closest(currentSelectors.message.join(', ')) || usernameElement.closest('.dtSdDz, .vod-message, .seventv-user-message') || usernameElement.parentElement;
+    const messageContainer = usernameElement.closest(getCompiledSelectors().message) || usernameElement.closest('.dtSdDz, .vod-message, .seventv-user-message') || usernameElement.parentElement;
     
     if (!messageContainer) return;
     // If a badge already exists, update it instead of returning
@@ -1889,197 +2907,27 @@ function addBadgeToMessage(usernameElement, rankData) {
     }
     
     // Prefer chat-mode specific placement (works for live and VOD)
-    switch (extensionState.chatMode) {
-      case 'seventv':
-        addBadgeToSevenTVMessage(messageContainer, usernameElement, rankData);
-        return;
-      case 'ffz':
-        addBadgeToFFZMessage(messageContainer, usernameElement, rankData);
-        return;
-      default:
-        break;
+    const adapterName = BadgeAdapters.nameFor(extensionState.chatMode, isVodPage());
+    if (adapterName) {
+      const adapter = BadgeAdapters.get(adapterName);
+      if (adapter) {
+        adapter.render(messageContainer, usernameElement, rankData);
+      } else {
+        // First badge before the adapter finished loading: render it once it arrives
+        BadgeAdapters.load(adapterName).then((loadedAdapter) => {
+          if (loadedAdapter && usernameElement.isConnected) BadgeRenderer.enqueue(usernameElement, rankData);
+        });
+      }
+      return;
     }
     
     // Standard Twitch chat
-    if (isVodPage()) {
-      addBadgeToVodMessage(messageContainer, usernameElement, rankData);
-    } else {
-      addBadgeToStandardMessage(messageContainer, rankData);
-    }
+    addBadgeToStandardMessage(messageContainer, rankData);
   } catch (error) {
     console.error('EloWard: Error adding badge:', error);
   }
 }
 
-function addBadgeToVodMessage(messageContainer, usernameElement, rankData) {
-  try {
-    // Find the VOD row container that holds badges + author + message
-    const vodRow = usernameElement.closest('.dtSdDz') || usernameElement.closest('.vod-message') || messageContainer;
-    if (!vodRow) return;
-    
-    // Prefer the first span before the author anchor as a badge host (matches live layout spacing)
-    let badgeHost = null;
-    const siblings = Array.from(vodRow.childNodes);
-    for (const node of siblings) {
-      if (node.nodeType === Node.ELEMENT_NODE && node.tagName === 'SPAN') {
-        badgeHost = node; break;
-      }
-      if (node === usernameElement) break;
-    }
-    if (!badgeHost) {
-      badgeHost = document.createElement('span');
-      badgeHost.className = 'eloward-badges-host';
-      vodRow.insertBefore(badgeHost, usernameElement);
-    }
-    
-    // Update existing badge if present
-    const existing = badgeHost.querySelector('.eloward-rank-badge');
-    if (existing) {
-      updateBadgeElement(existing, rankData);
-      return;
-    }
-    
-    const badge = createBadgeElement(rankData);
-    // Match live stream markup: wrap in a container div for consistent spacing
-    const badgeWrapper = document.createElement('div');
-    badgeWrapper.className = 'InjectLayout-sc-1i43xsx-0 dvtAVE';
-    badgeWrapper.appendChild(badge);
-    badgeHost.appendChild(badgeWrapper);
-  } catch (e) {
-    console.warn('EloWard (VOD): Failed to add badge', e);
-  }
-}
-
-function addBadgeToSevenTVMessage(messageContainer, _usernameElement, rankData) {
-  // Anchor at the top-level 7TV message wrapper to avoid matching mention tokens
-  const userWrapper = messageContainer.closest('.seventv-user-message') || messageContainer.closest('.seventv-chat-vod-message-patched') || messageContainer;
-  const chatUser = userWrapper.querySelector('.seventv-chat-user');
-  let badgeList = chatUser ? chatUser.querySelector('.seventv-chat-user-badge-list') : null;
-  let badgeListWasEmpty = false;
-  
-  if (!badgeList) {
-    if (!chatUser) return;
-    
-    badgeList = document.createElement('span');
-    badgeList.className = 'seventv-chat-user-badge-list';
-    badgeListWasEmpty = true;
-    
-    const usernameEl = chatUser.querySelector('.seventv-chat-user-username');
-    if (usernameEl) {
-      chatUser.insertBefore(badgeList, usernameEl);
-    } else {
-      chatUser.insertBefore(badgeList, chatUser.firstChild);
-    }
-  } else {
-    // Check if badge list only contains non-badge elements or is empty
-    const existingBadges = badgeList.querySelectorAll('.seventv-chat-badge:not(.eloward-rank-badge)');
-    badgeListWasEmpty = existingBadges.length === 0;
-  }
-
-  const existing = badgeList.querySelector('.eloward-rank-badge');
-  if (existing) {
-    updateBadgeElement(existing, rankData);
-    return;
-  }
-  
-  const badge = document.createElement('div');
-  badge.className = 'seventv-chat-badge eloward-rank-badge';
-  // Ensure rightmost position regardless of flex ordering
-  try { badge.style.order = '9999'; } catch (_) {}
-  
-  // If this is the only badge, adjust positioning to align with username
-  if (badgeListWasEmpty) {
-    badge.classList.add('eloward-single-badge');
-  }
-  
-  const isAnimated = rankData.animate_badge || false;
-  
-  badge.dataset.rankText = formatRankText(rankData);
-  badge.dataset.rank = rankData.tier.toLowerCase();
-  badge.dataset.division = rankData.division || '';
-  badge.dataset.lp = rankData.leaguePoints !== undefined && rankData.leaguePoints !== null ? 
-                     rankData.leaguePoints.toString() : '';
-  badge.dataset.username = rankData.summonerName || '';
-  badge.dataset.region = rankData.region;
-  badge.dataset.isAnimated = isAnimated ? 'true' : 'false';
-  
-  const img = document.createElement('img');
-  img.alt = rankData.tier;
-  img.className = 'eloward-badge-img';
-  img.width = 24;
-  img.height = 24;
-  img.decoding = 'async';
-  try { img.fetchPriority = 'high'; } catch (_) {}
-  img.loading = 'eager';
-  img.src = ImageCache.getSrcSync(rankData.tier, isAnimated);
-  
-  badge.appendChild(img);
-  badge.addEventListener('mouseenter', (e) => showSevenTVTooltip(e, rankData));
-  badge.addEventListener('mouseleave', () => hideSevenTVTooltip());
-  badge.addEventListener('click', handleBadgeClick);
-  badge.style.cursor = 'pointer';
-  
-  badgeList.appendChild(badge);
-}
-
-function showSevenTVTooltip(event, rankData) {
-  hideSevenTVTooltip();
-
-  if (!rankData?.tier) return;
-
-  const tooltip = document.createElement('div');
-  tooltip.className = 'eloward-7tv-tooltip';
-  tooltip.id = 'eloward-7tv-tooltip-active';
-
-  const tooltipBadge = document.createElement('img');
-  tooltipBadge.className = 'eloward-7tv-tooltip-badge';
-  tooltipBadge.decoding = 'async';
-  tooltipBadge.loading = 'eager';
-
-  const isAnimated = rankData.animate_badge || false;
-  tooltipBadge.src = ImageCache.getSrcSync(rankData.tier, isAnimated);
-  tooltipBadge.alt = 'Rank Badge';
-
-  const tooltipText = document.createElement('div');
-  tooltipText.className = 'eloward-7tv-tooltip-text';
-
-  const rankDiv = document.createElement('div');
-  rankDiv.className = 'eloward-rank-line';
-  rankDiv.textContent = formatRankTextForTooltip(rankData);
-  tooltipText.appendChild(rankDiv);
-
-  if (rankData.summonerName) {
-    const summonerDiv = document.createElement('div');
-    summonerDiv.className = 'eloward-summoner-line';
-    summonerDiv.textContent = rankData.summonerName;
-    tooltipText.appendChild(summonerDiv);
-  }
-
-  const displayRegion = getDisplayRegion(rankData.region);
-  if (displayRegion) {
-    const regionDiv = document.createElement('div');
-    regionDiv.className = 'eloward-region-line';
-    regionDiv.textContent = displayRegion;
-    tooltipText.appendChild(regionDiv);
-  }
-
-  const hintDiv = document.createElement('div');
-  hintDiv.className = 'eloward-hint';
-  hintDiv.textContent = 'Click to view OP.GG';
-  tooltipText.appendChild(hintDiv);
-
-  tooltip.appendChild(tooltipBadge);
-  tooltip.appendChild(tooltipText);
-
-  const rect = event.target.getBoundingClientRect();
-  const badgeCenter = rect.left + (rect.width / 2);
-
-  tooltip.style.left = `${badgeCenter}px`;
-  tooltip.style.top = `${rect.top - 5}px`;
-
-  document.body.appendChild(tooltip);
-}
-
 function formatRankTextForTooltip(rankData) {
   if (!rankData || !rankData.tier || rankData.tier.toUpperCase() === 'UNRANKED') {
     return 'UNRANKED';
@@ -2100,38 +2948,6 @@ function formatRankTextForTooltip(rankData) {
   return rankText;
 }
 
-function hideSevenTVTooltip() {
-  const existingTooltip = document.getElementById('eloward-7tv-tooltip-active');
-  if (existingTooltip && existingTooltip.parentNode) {
-    existingTooltip.remove();
-  }
-}
-
-function addBadgeToFFZMessage(messageContainer, usernameElement, rankData) {
-  // FFZ should use the same badge container approach as standard mode
-  const badgeContainer = findBadgeContainer(messageContainer);
-  
-  if (!badgeContainer) {
-    console.warn('EloWard: Could not find or create badge container for FFZ message');
-    return;
-  }
-  // Update if present
-  const existing = badgeContainer.querySelector('.eloward-rank-badge');
-  if (existing) {
-    updateBadgeElement(existing, rankData);
-    return;
-  }
-
-  const badge = createBadgeElement(rankData);
-  badge.classList.add('ffz-badge');
-  
-  // Create wrapper div to match other badges
-  const badgeWrapper = document.createElement('div');
-  badgeWrapper.className = 'InjectLayout-sc-1i43xsx-0 dvtAVE';
-  badgeWrapper.appendChild(badge);
-  badgeContainer.appendChild(badgeWrapper);
-}
-
 function addBadgeToStandardMessage(messageContainer, rankData) {
   // Find or create proper badge container - no fallbacks to username insertion
   const badgeContainer = findBadgeContainer(messageContainer);
@@ -2141,64 +2957,52 @@ function addBadgeToStandardMessage(messageContainer, rankData) {
     return;
   }
   
-  const badge = createBadgeElement(rankData);
-  
-  // Handle different wrapper structures based on chat mode
-  if (extensionState.chatMode === 'seventv') {
-    // 7TV mode - add directly to badge list
-    badgeContainer.appendChild(badge);
-  } else {
-    // Standard/FFZ mode - create wrapper div to match other badges
-    const badgeWrapper = document.createElement('div');
-    badgeWrapper.className = 'InjectLayout-sc-1i43xsx-0 dvtAVE';
-    badgeWrapper.appendChild(badge);
-    badgeContainer.appendChild(badgeWrapper);
-  }
+  badgeContainer.appendChild(BadgeRenderer.clone(rankData, 'standard').fragment);
 }
 
-function findBadgeContainer(messageContainer) {
-  // Handle 7TV mode first
-  if (extensionState.chatMode === 'seventv') {
-    const seventvBadgeList = messageContainer.querySelector('.seventv-chat-user-badge-list');
-    if (seventvBadgeList) {
-      return seventvBadgeList;
-    }
-  }
-  
-  // First, look for existing badge container (works with FFZ and other extensions)
-  const existingBadgeContainer = messageContainer.querySelector('.chat-line__message--badges');
-  if (existingBadgeContainer) {
-    return existingBadgeContainer;
-  }
-  
-  // Handle standard Twitch chat - look for the badge container structure
-  // Pattern: .chat-line__username-container > span (contains badge wrappers)
-  const usernameContainer = messageContainer.querySelector('.chat-line__username-container');
-  if (usernameContainer) {
-    // Look for the span that contains badge wrappers
-    const badgeSpan = usernameContainer.querySelector('span');
-    if (badgeSpan && badgeSpan.querySelector('[data-a-target="chat-badge"]')) {
-      return badgeSpan;
-    }
-    
-    // If no badges exist yet, create the structure if we find the username container
-    if (badgeSpan && !badgeSpan.querySelector('[data-a-target="chat-badge"]')) {
-      // This span might be for badges but empty, let's use it
-      return badgeSpan;
-    }
-  }
-  
-  // Fallback: look for any existing badge and get its parent container
-  const existingBadge = messageContainer.querySelector('[data-a-target="chat-badge"]');
-  if (existingBadge) {
-    // Go up to find the container that holds all badges
+// Ways to locate an existing badge container, tried in order. The first one that works for
+// a message layout is remembered so later messages with the same layout go straight to it.
+const BADGE_CONTAINER_STRATEGIES = [
+  // 7TV badge list
+  (messageContainer) => extensionState.chatMode === 'seventv'
+    ? messageContainer.querySelector('.seventv-chat-user-badge-list')
+    : null,
+  // Existing badge container (works with FFZ and other extensions)
+  (messageContainer) => messageContainer.querySelector('.chat-line__message--badges'),
+  // Standard Twitch chat: .chat-line__username-container > span (contains badge wrappers, may be empty)
+  (messageContainer) => {
+    const usernameContainer = messageContainer.querySelector('.chat-line__username-container');
+    return usernameContainer ? usernameContainer.querySelector('span') : null;
+  },
+  // Any existing badge: walk up to the span that contains badge wrappers
+  (messageContainer) => {
+    const existingBadge = messageContainer.querySelector('[data-a-target="chat-badge"]');
+    if (!existingBadge) return null;
     let parent = existingBadge.parentElement;
     while (parent && !parent.querySelector('[data-a-target="chat-badge"]')) {
       parent = parent.parentElement;
       if (parent === messageContainer) break;
     }
-    if (parent && parent !== messageContainer) {
-      return parent.parentElement; // The span that contains badge wrappers
+    return parent && parent !== messageContainer ? parent.parentElement : null;
+  }
+];
+
+const badgeContainerStrategyByLayout = new Map(); // `${chatMode}|${className}` -> strategy index
+
+function findBadgeContainer(messageContainer) {
+  const layoutKey = `${extensionState.chatMode}|${messageContainer.className}`;
+  const cachedIndex = badgeContainerStrategyByLayout.get(layoutKey);
+  if (cachedIndex !== undefined) {
+    const cached = BADGE_CONTAINER_STRATEGIES[cachedIndex](messageContainer);
+    if (cached) return cached;
+  }
+
+  for (let index = 0; index < BADGE_CONTAINER_STRATEGIES.length; index++) {
+    if (index === cachedIndex) continue;
+    const container = BADGE_CONTAINER_STRATEGIES[index](messageContainer);
+    if (container) {
+      badgeContainerStrategyByLayout.set(layoutKey, index);
+      return container;
     }
   }
   
@@ -2235,13 +3039,7 @@ function updateBadgeElement(badgeElement, rankData) {
     
     const isAnimated = rankData.animate_badge || false;
     
-    badgeElement.dataset.rankText = formatRankText(rankData);
-    badgeElement.dataset.rank = rankData.tier.toLowerCase();
-    badgeElement.dataset.division = rankData.division || '';
-    badgeElement.dataset.lp = rankData.leaguePoints !== undefined && rankData.leaguePoints !== null ? String(rankData.leaguePoints) : '';
-    badgeElement.dataset.username = rankData.summonerName || '';
-    badgeElement.dataset.region = rankData.region || '';
-    badgeElement.dataset.isAnimated = isAnimated ? 'true' : 'false';
+    applyBadgeData(badgeElement, rankData);
 
     const img = badgeElement.querySelector('img');
     if (img) {
@@ -2279,95 +3077,153 @@ function formatRankText(rankData) {
   return rankText;
 }
 
-function showTooltip(event) {
-  if (!tooltipElement) {
-    tooltipElement = document.createElement('div');
-    tooltipElement.className = 'eloward-tooltip';
-    document.body.appendChild(tooltipElement);
-  }
+// Tooltips are built once per style (standard / 7TV) and reused for every badge. One set of
+// delegated listeners on the chat container reads the hovered badge's dataset, updates the
+// tooltip through textContent, and positions it in the next animation frame.
+const BadgeTooltips = (() => {
+  const tooltips = { standard: null, seventv: null };
+  let activeBadge = null;
+  let positionFrame = null;
+  let delegateRoot = null;
 
-  const badge = event.currentTarget;
-  const rankTier = badge.dataset.rank || 'UNRANKED';
-  const division = badge.dataset.division || '';
-  let lp = badge.dataset.lp || '';
-  const regionCode = badge.dataset.region || '';
-  const summonerName = badge.dataset.username || '';
-  const displayRegion = getDisplayRegion(regionCode);
+  function build(style) {
+    const prefix = style === 'seventv' ? 'eloward-7tv-tooltip' : 'eloward-tooltip';
 
-  if (lp && !isNaN(Number(lp))) {
-    lp = Number(lp).toString();
-  }
+    const root = document.createElement('div');
+    root.className = prefix;
+
+    const badgeImg = document.createElement('img');
+    badgeImg.className = `${prefix}-badge`;
+    badgeImg.alt = 'Rank Badge';
+    badgeImg.decoding = 'async';
+    badgeImg.loading = 'eager';
+
+    const text = document.createElement('div');
+    text.className = `${prefix}-text`;
 
-  while (tooltipElement.firstChild) {
-    tooltipElement.removeChild(tooltipElement.firstChild);
+    const rankLine = document.createElement('div');
+    rankLine.className = 'eloward-rank-line';
+    const summonerLine = document.createElement('div');
+    summonerLine.className = 'eloward-summoner-line';
+    const regionLine = document.createElement('div');
+    regionLine.className = 'eloward-region-line';
+    const hint = document.createElement('div');
+    hint.className = 'eloward-hint';
+    hint.textContent = 'Click to view OP.GG';
+
+    text.append(rankLine, summonerLine, regionLine, hint);
+    root.append(badgeImg, text);
+    document.body.appendChild(root);
+
+    return { root, badgeImg, rankLine, summonerLine, regionLine };
   }
 
-  const tooltipBadge = document.createElement('img');
-  tooltipBadge.className = 'eloward-tooltip-badge';
-  const originalImg = badge.querySelector('img');
-  if (originalImg && originalImg.src) {
-    tooltipBadge.src = originalImg.src;
-    tooltipBadge.alt = 'Rank Badge';
+  function getTooltip(style) {
+    let tooltip = tooltips[style];
+    if (!tooltip || !tooltip.root.isConnected) {
+      tooltip = build(style);
+      tooltips[style] = tooltip;
+    }
+    return tooltip;
   }
-  tooltipElement.appendChild(tooltipBadge);
 
-  const tooltipText = document.createElement('div');
-  tooltipText.className = 'eloward-tooltip-text';
+  function show(badge) {
+    hide();
+    activeBadge = badge;
 
-  const rankDiv = document.createElement('div');
-  rankDiv.className = 'eloward-rank-line';
-  if (!rankTier || rankTier.toUpperCase() === 'UNRANKED') {
-    rankDiv.textContent = 'UNRANKED';
-  } else {
-    let formattedTier = rankTier.toUpperCase();
-    let rankText = formattedTier;
-    if (division && !['MASTER', 'GRANDMASTER', 'CHALLENGER'].includes(rankTier.toUpperCase())) {
-      rankText += ' ' + division;
+    const style = badge.classList.contains('seventv-chat-badge') ? 'seventv' : 'standard';
+    const tooltip = getTooltip(style);
+    const { rank, division, lp, username, region } = badge.dataset;
+
+    tooltip.rankLine.textContent = formatRankTextForTooltip({
+      tier: (rank || 'UNRANKED').toUpperCase(),
+      division: division || '',
+      leaguePoints: lp === undefined || lp === '' || isNaN(Number(lp)) ? null : Number(lp)
+    });
+
+    tooltip.summonerLine.textContent = username || '';
+    tooltip.summonerLine.hidden = !username;
+
+    const displayRegion = getDisplayRegion(region || '');
+    tooltip.regionLine.textContent = displayRegion || '';
+    tooltip.regionLine.hidden = !displayRegion;
+
+    const badgeImg = badge.querySelector('img');
+    if (badgeImg && badgeImg.src && tooltip.badgeImg.src !== badgeImg.src) {
+      tooltip.badgeImg.src = badgeImg.src;
     }
-    if (lp !== undefined && lp !== null && lp !== '') {
-      rankText += ' - ' + lp + ' LP';
+
+    // Read the badge rect in a frame so hovering never forces a synchronous layout
+    positionFrame = requestAnimationFrame(() => {
+      positionFrame = null;
+      if (activeBadge !== badge || !badge.isConnected) return;
+      const rect = badge.getBoundingClientRect();
+      tooltip.root.style.left = `${rect.left + (rect.width / 2)}px`;
+      tooltip.root.style.top = `${rect.top - 5}px`;
+      tooltip.root.classList.add('visible');
+    });
+  }
+
+  function hide() {
+    activeBadge = null;
+    if (positionFrame) {
+      cancelAnimationFrame(positionFrame);
+      positionFrame = null;
+    }
+    for (const tooltip of Object.values(tooltips)) {
+      if (tooltip) tooltip.root.classList.remove('visible');
     }
-    rankDiv.textContent = rankText;
   }
-  tooltipText.appendChild(rankDiv);
 
-  if (summonerName) {
-    const summonerDiv = document.createElement('div');
-    summonerDiv.className = 'eloward-summoner-line';
-    summonerDiv.textContent = summonerName;
-    tooltipText.appendChild(summonerDiv);
+  function badgeFromEvent(event) {
+    const target = event.target;
+    return target && target.closest ? target.closest('.eloward-rank-badge') : null;
   }
 
-  if (displayRegion) {
-    const regionDiv = document.createElement('div');
-    regionDiv.className = 'eloward-region-line';
-    regionDiv.textContent = displayRegion;
-    tooltipText.appendChild(regionDiv);
+  function onMouseOver(event) {
+    const badge = badgeFromEvent(event);
+    if (badge && badge !== activeBadge) show(badge);
   }
 
-  const hintDiv = document.createElement('div');
-  hintDiv.className = 'eloward-hint';
-  hintDiv.textContent = 'Click to view OP.GG';
-  tooltipText.appendChild(hintDiv);
+  function onMouseOut(event) {
+    if (!activeBadge || badgeFromEvent(event) !== activeBadge) return;
+    // Moving between the badge and its image is not leaving the badge
+    if (event.relatedTarget && activeBadge.contains(event.relatedTarget)) return;
+    hide();
+  }
 
-  tooltipElement.appendChild(tooltipText);
+  function onClick(event) {
+    const badge = badgeFromEvent(event);
+    if (badge) handleBadgeClick(badge);
+  }
 
-  const rect = badge.getBoundingClientRect();
-  const badgeCenter = rect.left + (rect.width / 2);
+  // Capture phase so chat clients that stop propagation on their own badges don't swallow ours
+  function attach(root) {
+    if (delegateRoot === root) return;
+    detach();
+    root.addEventListener('mouseover', onMouseOver, true);
+    root.addEventListener('mouseout', onMouseOut, true);
+    root.addEventListener('click', onClick, true);
+    delegateRoot = root;
+  }
 
-  tooltipElement.style.left = `${badgeCenter}px`;
-  tooltipElement.style.top = `${rect.top - 5}px`;
-  tooltipElement.classList.add('visible');
-}
+  function detach() {
+    hide();
+    if (!delegateRoot) return;
+    delegateRoot.removeEventListener('mouseover', onMouseOver, true);
+    delegateRoot.removeEventListener('mouseout', onMouseOut, true);
+    delegateRoot.removeEventListener('click', onClick, true);
+    delegateRoot = null;
+  }
+
+  return { attach, detach, hide };
+})();
 
 function hideTooltip() {
-  if (tooltipElement && tooltipElement.classList.contains('visible')) {
-    tooltipElement.classList.remove('visible');
-  }
+  BadgeTooltips.hide();
 }
 
 initializeStorage();
-setupUrlChangeObserver();
 detectChatMode();
 setupCompatibilityMonitor();
 setupFallbackInitialization();
@@ -2382,23 +3238,24 @@ initializeExtension();
 
 window.addEventListener('blur', () => {
   hideTooltip();
-  hideSevenTVTooltip();
 });
 
 window.addEventListener('popstate', function() {
-  // Clear cache on page refresh/navigation to detect newly joined EloWard users
+  // Clear cache on page refresh/navigation to detect newly joined EloWard users.
+  // Re-initialization is driven by handleNavigation once the route is ready.
   try {
     chrome.runtime.sendMessage({ action: 'clear_rank_cache_except_current_user' });
   } catch (_) {}
-  
-  if (!extensionState.initializationInProgress) {
-    initializeExtension();
-  }
 });
 
 // Listen for immediate rank cache updates from background (especially local user)
 try {
-  chrome.runtime.onMessage.addListener((message) => {
+  chrome.runtime.onMessage.addListener((message, _sender, sendResponse) => {
+    if (message && message.type === 'eloward_get_metrics') {
+      sendResponse({ metrics: EloWardMetrics.snapshot(), channel: extensionState.channelName || null });
+      return false;
+    }
+
     if (message && message.type === 'rank_data_updated' && message.username && message.rankData) {
       try {
         applyRankToAllUserMessagesInChat(message.username, message.rankData);
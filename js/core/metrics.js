@@ -0,0 +1,114 @@
+/* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
+
+// In-extension performance metrics, shared by the background and content scripts.
+// Loaded as a plain script (content) or a side-effect import (background) and exposed as
+// globalThis.EloWardMetrics. Off by default: every recording call returns immediately until
+// eloward_metrics_enabled is set, so the instrumentation left in hot paths costs one branch.
+
+(() => {
+  if (globalThis.EloWardMetrics) return;
+
+  const ENABLED_KEY = 'eloward_metrics_enabled';
+  // Histogram bucket upper bounds in ms; the last bucket catches everything slower
+  const BUCKET_BOUNDS = [0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000];
+
+  const counters = new Map(); // name -> count
+  const histograms = new Map(); // name -> { buckets, count, sum, max }
+  let enabled = false;
+  let startedAt = Date.now();
+
+  function count(name, amount = 1) {
+    if (!enabled) return;
+    counters.set(name, (counters.get(name) || 0) + amount);
+  }
+
+  function observe(name, valueMs) {
+    if (!enabled) return;
+    let histogram = histograms.get(name);
+    if (!histogram) {
+      histogram = { buckets: new Uint32Array(BUCKET_BOUNDS.length + 1), count: 0, sum: 0, max: 0 };
+      histograms.set(name, histogram);
+    }
+    let index = 0;
+    while (index < BUCKET_BOUNDS.length && valueMs > BUCKET_BOUNDS[index]) index++;
+    histogram.buckets[index]++;
+    histogram.count++;
+    histogram.sum += valueMs;
+    if (valueMs > histogram.max) histogram.max = valueMs;
+  }
+
+  // const start = EloWardMetrics.start(); ... EloWardMetrics.end('name', start);
+  function start() {
+    return enabled ? performance.now() : 0;
+  }
+
+  function end(name, startTime) {
+    if (!enabled || !startTime) return;
+    observe(name, performance.now() - startTime);
+  }
+
+  // Upper bound of the bucket holding the given quantile
+  function quantile(histogram, q) {
+    const target = histogram.count * q;
+    let seen = 0;
+    for (let index = 0; index < histogram.buckets.length; index++) {
+      seen += histogram.buckets[index];
+      if (seen >= target) return index < BUCKET_BOUNDS.length ? BUCKET_BOUNDS[index] : histogram.max;
+    }
+    return histogram.max;
+  }
+
+  function snapshot() {
+    const histogramSummary = {};
+    for (const [name, histogram] of histograms) {
+      histogramSummary[name] = {
+        count: histogram.count,
+        avg: histogram.count ? Math.round((histogram.sum / histogram.count) * 100) / 100 : 0,
+        p50: quantile(histogram, 0.5),
+        p95: quantile(histogram, 0.95),
+        max: Math.round(histogram.max * 100) / 100,
+        buckets: Object.fromEntries(Array.from(histogram.buckets, (value, index) => [
+          index < BUCKET_BOUNDS.length ? `<=${BUCKET_BOUNDS[index]}` : `>${BUCKET_BOUNDS[BUCKET_BOUNDS.length - 1]}`,
+          value
+        ]))
+      };
+    }
+    return {
+      enabled,
+      since: startedAt,
+      counters: Object.fromEntries(counters),
+      histograms: histogramSummary
+    };
+  }
+
+  function reset() {
+    counters.clear();
+    histograms.clear();
+    startedAt = Date.now();
+  }
+
+  function setEnabled(value) {
+    const next = !!value;
+    if (next && !enabled) reset();
+    enabled = next;
+  }
+
+  try {
+    const api = globalThis.chrome || globalThis.browser; // chrome.* keeps the callback form in every browser
+    api.storage.local.get([ENABLED_KEY], (data) => setEnabled(data?.[ENABLED_KEY]));
+    api.storage.onChanged.addListener((changes, areaName) => {
+      if (areaName === 'local' && changes[ENABLED_KEY]) setEnabled(changes[ENABLED_KEY].newValue);
+    });
+  } catch (_) {}
+
+  globalThis.EloWardMetrics = {
+    ENABLED_KEY,
+    isEnabled: () => enabled,
+    count,
+    observe,
+    start,
+    end,
+    snapshot,
+    reset
+  };
+})();
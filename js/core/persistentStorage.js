@@ -2,17 +2,16 @@
 
 // Import webextension-polyfill for cross-browser compatibility
 import '../../vendor/browser-polyfill.js';
+import './storageMirror.js';
 
-const STORAGE_KEYS = {
-  RIOT_USER_DATA: 'eloward_persistent_riot_user_data',
-  TWITCH_USER_DATA: 'eloward_persistent_twitch_user_data',
-  CONNECTED_STATE: 'eloward_persistent_connected_state',
-  DATA_PERSISTENCE_ENABLED: 'eloward_data_persistence_enabled'
-};
+// Reads are served from the in-memory mirror and writes in the same tick share one storage call
+export const StorageMirror = globalThis.EloWardStorage;
+
+const STORAGE_KEYS = StorageMirror.KEYS;
 
 export const PersistentStorage = {
   async init() {
-    await browser.storage.local.set({
+    await StorageMirror.set({
       [STORAGE_KEYS.DATA_PERSISTENCE_ENABLED]: true
     });
   },
@@ -20,7 +19,7 @@ export const PersistentStorage = {
   async storeRiotUserData(userData) {
     if (!userData || !userData.puuid) return;
 
-    const currentData = await browser.storage.local.get(['selectedRegion']);
+    const currentData = await StorageMirror.get(['selectedRegion']);
 
     // Normalize soloQueueRank structure before storing to ensure consistency
     let normalizedRank = null;
@@ -43,19 +42,24 @@ export const PersistentStorage = {
       animate_badge: userData.animate_badge
     };
 
-    await browser.storage.local.set({
+    // Not awaited yet, so the connected state below lands in the same write
+    const write = StorageMirror.set({
       [STORAGE_KEYS.RIOT_USER_DATA]: persistentData,
       [STORAGE_KEYS.DATA_PERSISTENCE_ENABLED]: true
     });
 
     await this.updateConnectedState('riot', true);
+    await write;
   },
   
   async getRiotUserData() {
-    const data = await browser.storage.local.get([STORAGE_KEYS.RIOT_USER_DATA]);
-    const storedData = data[STORAGE_KEYS.RIOT_USER_DATA];
+    const data = await StorageMirror.get([STORAGE_KEYS.RIOT_USER_DATA]);
+    const mirrored = data[STORAGE_KEYS.RIOT_USER_DATA];
+
+    if (!mirrored) return null;
 
-    if (!storedData) return null;
+    // Copy so callers never modify the mirrored object
+    const storedData = { ...mirrored };
 
     // Normalize soloQueueRank structure to ensure consistency
     if (storedData.soloQueueRank && typeof storedData.soloQueueRank === 'object') {
@@ -86,7 +90,7 @@ export const PersistentStorage = {
       animate_badge: optionsData.animate_badge
     };
     
-    await browser.storage.local.set({
+    await StorageMirror.set({
       [STORAGE_KEYS.RIOT_USER_DATA]: updatedData
     });
   },
@@ -101,32 +105,33 @@ export const PersistentStorage = {
       profile_image_url: userData.profile_image_url
     };
     
-    await browser.storage.local.set({
+    const write = StorageMirror.set({
       [STORAGE_KEYS.TWITCH_USER_DATA]: persistentData,
       [STORAGE_KEYS.DATA_PERSISTENCE_ENABLED]: true
     });
     
     await this.updateConnectedState('twitch', true);
+    await write;
   },
   
   async getTwitchUserData() {
-    const data = await browser.storage.local.get([STORAGE_KEYS.TWITCH_USER_DATA]);
+    const data = await StorageMirror.get([STORAGE_KEYS.TWITCH_USER_DATA]);
     return data[STORAGE_KEYS.TWITCH_USER_DATA] || null;
   },
   
   async updateConnectedState(service, isConnected) {
-    const data = await browser.storage.local.get([STORAGE_KEYS.CONNECTED_STATE]);
-    const connectedState = data[STORAGE_KEYS.CONNECTED_STATE] || {};
+    const data = await StorageMirror.get([STORAGE_KEYS.CONNECTED_STATE]);
+    const connectedState = { ...data[STORAGE_KEYS.CONNECTED_STATE] };
     
     connectedState[service] = isConnected;
     
-    await browser.storage.local.set({
+    await StorageMirror.set({
       [STORAGE_KEYS.CONNECTED_STATE]: connectedState
     });
   },
   
   async getConnectedState() {
-    const data = await browser.storage.local.get([STORAGE_KEYS.CONNECTED_STATE]);
+    const data = await StorageMirror.get([STORAGE_KEYS.CONNECTED_STATE]);
     const storedState = data[STORAGE_KEYS.CONNECTED_STATE] || {};
     
     // Always return complete state object with explicit false values
@@ -143,16 +148,16 @@ export const PersistentStorage = {
   
   async clearServiceData(service) {
     if (service === 'riot') {
-      await browser.storage.local.remove([STORAGE_KEYS.RIOT_USER_DATA]);
+      await StorageMirror.remove([STORAGE_KEYS.RIOT_USER_DATA]);
     } else if (service === 'twitch') {
-      await browser.storage.local.remove([STORAGE_KEYS.TWITCH_USER_DATA]);
+      await StorageMirror.remove([STORAGE_KEYS.TWITCH_USER_DATA]);
     }
     
     await this.updateConnectedState(service, false);
   },
   
   async clearAllData() {
-    await browser.storage.local.remove([
+    await StorageMirror.remove([
       STORAGE_KEYS.RIOT_USER_DATA,
       STORAGE_KEYS.TWITCH_USER_DATA,
       STORAGE_KEYS.CONNECTED_STATE
@@ -234,7 +239,7 @@ export const PersistentStorage = {
 
       // Store the region first so storeRiotUserData can use it
       if (data.riot_data.region) {
-        await browser.storage.local.set({ selectedRegion: data.riot_data.region });
+        await StorageMirror.set({ selectedRegion: data.riot_data.region });
       }
 
       // Store the riot data using existing method
@@ -0,0 +1,190 @@
+/* Copyright 2024 EloWard - Apache 2.0 + Commons Clause License */
+
+// In-memory mirror of browser.storage.local, shared by the background, popup and content scripts.
+// Loaded as a plain script (content) or through persistentStorage.js (extension pages) and exposed
+// as globalThis.EloWardStorage. Keys are read from storage once; storage.onChanged keeps them
+// current after that, so repeated reads are answered from memory. Writes issued within the same
+// task (including read-modify-write chains of awaits) are merged into a single storage.local.set.
+
+(() => {
+  if (globalThis.EloWardStorage) return;
+
+  const KEYS = {
+    RIOT_USER_DATA: 'eloward_persistent_riot_user_data',
+    TWITCH_USER_DATA: 'eloward_persistent_twitch_user_data',
+    CONNECTED_STATE: 'eloward_persistent_connected_state',
+    DATA_PERSISTENCE_ENABLED: 'eloward_data_persistence_enabled',
+    USER_OPTIONS: 'eloward_user_options'
+  };
+
+  const api = globalThis.chrome || globalThis.browser; // chrome.* keeps the callback form in every browser
+  const values = new Map(); // key -> last known value (undefined when absent)
+  const loading = new Map(); // key -> promise of an in-flight initial read
+  let pendingSet = null; // key -> value, merged until the end of the task
+  let pendingRemove = null; // Set of keys
+  let pendingFlush = null;
+
+  function callStorage(method, arg) {
+    return new Promise((resolve, reject) => {
+      try {
+        api.storage.local[method](arg, (result) => {
+          const error = api.runtime?.lastError;
+          if (error) reject(new Error(error.message));
+          else resolve(result);
+        });
+      } catch (error) {
+        reject(error);
+      }
+    });
+  }
+
+  function isPending(key) {
+    return !!(pendingSet?.has(key) || pendingRemove?.has(key));
+  }
+
+  // Read the keys not mirrored yet; concurrent callers share one read per key
+  function load(keys) {
+    const missing = keys.filter(key => !values.has(key) && !loading.has(key));
+    if (missing.length > 0) {
+      const read = callStorage('get', missing)
+        .then((data) => {
+          for (const key of missing) {
+            // A local write or a change event that landed first is newer than this read
+            if (!values.has(key)) values.set(key, data?.[key]);
+          }
+        })
+        .catch(() => {})
+        .finally(() => {
+          for (const key of missing) loading.delete(key);
+        });
+      for (const key of missing) loading.set(key, read);
+    }
+
+    const waits = [];
+    for (const key of keys) {
+      const read = loading.get(key);
+      if (read && !waits.includes(read)) waits.push(read);
+    }
+    return waits.length > 0 ? Promise.all(waits) : null;
+  }
+
+  // Callers get their own top-level object, so editing a result can't change the mirror
+  function copy(value) {
+    if (Array.isArray(value)) return value.slice();
+    if (value && typeof value === 'object') return { ...value };
+    return value;
+  }
+
+  function pick(keys) {
+    const result = {};
+    for (const key of keys) {
+      const value = values.get(key);
+      if (value !== undefined) result[key] = copy(value);
+    }
+    return result;
+  }
+
+  // Same result shape as storage.local.get(keys); no I/O once the keys are mirrored
+  function get(keys) {
+    const list = Array.isArray(keys) ? keys : [keys];
+    const waiting = load(list);
+    return waiting ? waiting.then(() => pick(list)) : Promise.resolve(pick(list));
+  }
+
+  // Synchronous read for hot paths; undefined until the key has been loaded.
+  // Returns the mirror's own value, so treat it as read-only
+  function peek(key) {
+    return values.get(key);
+  }
+
+  function has(key) {
+    return values.has(key);
+  }
+
+  function scheduleFlush() {
+    if (!pendingFlush) {
+      pendingFlush = new Promise(resolve => setTimeout(resolve, 0)).then(flush);
+    }
+    return pendingFlush;
+  }
+
+  async function flush() {
+    const items = pendingSet;
+    const removals = pendingRemove;
+    pendingSet = null;
+    pendingRemove = null;
+    pendingFlush = null;
+
+    const writes = [];
+    if (items && items.size > 0) writes.push(callStorage('set', Object.fromEntries(items)));
+    if (removals && removals.size > 0) writes.push(callStorage('remove', Array.from(removals)));
+    try {
+      await Promise.all(writes);
+      return true;
+    } catch (error) {
+      // The mirror ran ahead of storage: forget the written keys and read them back, unless
+      // a newer write for a key is already queued. Settles rather than rejects, since most
+      // writers don't wait on the result
+      const keys = [...(items ? items.keys() : []), ...(removals || [])].filter(key => !isPending(key));
+      for (const key of keys) values.delete(key);
+      load(keys);
+      console.warn('[EloWard Storage] Write failed:', error?.message || error);
+      return false;
+    }
+  }
+
+  // Updates the mirror immediately; resolves true once the merged write reaches storage,
+  // false if storage refused it (never rejects)
+  function set(items) {
+    if (!items) return Promise.resolve(true);
+    if (!pendingSet) pendingSet = new Map();
+    for (const [key, value] of Object.entries(items)) {
+      values.set(key, value);
+      pendingSet.set(key, value);
+      pendingRemove?.delete(key);
+    }
+    return scheduleFlush();
+  }
+
+  function remove(keys) {
+    const list = Array.isArray(keys) ? keys : [keys];
+    if (!pendingRemove) pendingRemove = new Set();
+    for (const key of list) {
+      values.set(key, undefined);
+      pendingRemove.add(key);
+      pendingSet?.delete(key);
+    }
+    return scheduleFlush();
+  }
+
+  try {
+    api.storage.onChanged.addListener((changes, areaName) => {
+      if (areaName !== 'local') return;
+      for (const [key, change] of Object.entries(changes)) {
+        // Only mirrored keys are tracked (rank cache shards never enter the mirror unless read),
+        // and our own unflushed write is newer than whatever this event reports
+        if ((!values.has(key) && !loading.has(key)) || isPending(key)) continue;
+        values.set(key, change.newValue);
+      }
+    });
+  } catch (_) {}
+
+  // The typed keys are small and read everywhere, so mirror them up front
+  load(Object.values(KEYS));
+
+  globalThis.EloWardStorage = {
+    KEYS,
+    get,
+    peek,
+    has,
+    set,
+    remove,
+    flush: () => pendingFlush || Promise.resolve(true),
+
+    // Typed accessors over the mirror
+    riotUserData: () => peek(KEYS.RIOT_USER_DATA) || null,
+    twitchUserData: () => peek(KEYS.TWITCH_USER_DATA) || null,
+    userOptions: () => peek(KEYS.USER_OPTIONS) || null,
+    isPersistenceEnabled: () => !!peek(KEYS.DATA_PERSISTENCE_ENABLED)
+  };
+})();
@@ -2,7 +2,7 @@
 
 import { RiotAuth } from './auth/riotAuth.js';
 import { TwitchAuth } from './auth/twitchAuth.js';
-import { PersistentStorage } from './core/persistentStorage.js';
+import { PersistentStorage, StorageMirror } from './core/persistentStorage.js';
 
 document.addEventListener('DOMContentLoaded', () => {
 
@@ -21,6 +21,12 @@ document.addEventListener('DOMContentLoaded', () => {
   const accountContent = document.getElementById('account-content');
   const accountDropdownArrow = accountHeader.querySelector('.dropdown-arrow');
   const premiumStar = document.getElementById('premium-star');
+
+  // Badge cache versioning - increment this when badge images are updated on CDN
+  const BADGE_CACHE_VERSION = '3';
+  const UNRANKED_BADGE_URL = `https://eloward-cdn.unleashai.workers.dev/lol/unranked.png?v=${BADGE_CACHE_VERSION}`;
+  // Last view model from the background (popupViewModel), painted before anything async runs
+  const VIEW_MODEL_CACHE_KEY = 'eloward_popup_view_model';
   
 
 
@@ -271,6 +277,90 @@ document.addEventListener('DOMContentLoaded', () => {
   }
 
 
+  function readCachedViewModel() {
+    try {
+      return JSON.parse(localStorage.getItem(VIEW_MODEL_CACHE_KEY));
+    } catch (_) {
+      return null;
+    }
+  }
+
+  function cacheViewModel(viewModel) {
+    try {
+      localStorage.setItem(VIEW_MODEL_CACHE_KEY, JSON.stringify(viewModel));
+    } catch (_) {}
+  }
+
+  function paintSection(content, arrow, collapsed) {
+    content.style.display = collapsed ? 'none' : 'block';
+    arrow.classList.toggle('rotated', !collapsed);
+  }
+
+  // Synchronous paint of a view model; checkAuthStatus and the rank refresh reconcile it afterwards
+  function paintViewModel(viewModel) {
+    paintSection(accountContent, accountDropdownArrow, viewModel.sections?.accountCollapsed);
+    paintSection(optionsContent, optionsDropdownArrow, viewModel.sections?.optionsCollapsed);
+
+    if (viewModel.twitch) {
+      twitchConnectionStatus.textContent = viewModel.twitch.name;
+      twitchConnectionStatus.classList.add('connected');
+      connectTwitchBtn.textContent = 'Disconnect';
+    } else {
+      twitchConnectionStatus.textContent = 'Not Connected';
+      twitchConnectionStatus.classList.remove('connected', 'error');
+      connectTwitchBtn.textContent = 'Connect';
+    }
+
+    if (viewModel.selectedRegion) regionSelect.value = viewModel.selectedRegion;
+
+    if (viewModel.riot) {
+      riotConnectionStatus.textContent = viewModel.riot.riotId;
+      riotConnectionStatus.classList.add('connected');
+      updateRiotButtonText('Disconnect');
+      refreshRankBtn.classList.remove('hidden');
+      regionSelect.classList.add('hidden');
+    } else {
+      riotConnectionStatus.textContent = 'Not Connected';
+      riotConnectionStatus.classList.remove('connected', 'error');
+      updateRiotButtonText('Connect');
+      refreshRankBtn.classList.add('hidden');
+      regionSelect.classList.remove('hidden');
+    }
+
+    if (viewModel.rank) {
+      const { formattedTier, rankText } = formatRank(viewModel.rank);
+      const rankImageFileName = formattedTier.toLowerCase();
+      currentRank.textContent = rankText;
+      rankBadgePreview.style.backgroundImage = `url('${rankBadgeUrl(rankImageFileName, viewModel.options.animate_badge)}')`;
+      positionRankBadge(rankImageFileName);
+    } else {
+      currentRank.textContent = 'Unranked';
+      rankBadgePreview.style.backgroundImage = `url('${UNRANKED_BADGE_URL}')`;
+      rankBadgePreview.style.transform = 'translateY(-3px)';
+    }
+
+    updatePremiumStar(viewModel.options.plus_active);
+    initializePlusFeatures(viewModel.options.plus_active);
+    const showPeakToggle = document.getElementById('use-peak-rank');
+    const animateBadgeToggle = document.getElementById('show-animated-badge');
+    if (showPeakToggle) showPeakToggle.checked = viewModel.options.show_peak;
+    if (animateBadgeToggle) animateBadgeToggle.checked = viewModel.options.animate_badge;
+    updateOptionsBasedOnRiotConnection();
+  }
+
+
+  const cachedViewModel = readCachedViewModel();
+  if (cachedViewModel) {
+    try { paintViewModel(cachedViewModel); } catch (_) {}
+  }
+
+  // Keep the cache current for the next open; the background pushes later changes itself
+  browser.runtime.sendMessage({ action: 'get_popup_view_model' })
+    .then((response) => {
+      if (response?.viewModel) cacheViewModel(response.viewModel);
+    })
+    .catch(() => {});
+
   PersistentStorage.init();
   
 
@@ -281,8 +371,13 @@ document.addEventListener('DOMContentLoaded', () => {
 
   // Initialize options as disabled until we know connection status
   updateOptionsBasedOnRiotConnection();
+  initializeMetricsOptions();
 
-  setRiotControlsDisabled(true, 'no_twitch');
+  if (cachedViewModel) {
+    updateRiotControlsBasedOnTwitchStatus();
+  } else {
+    setRiotControlsDisabled(true, 'no_twitch');
+  }
 
 
   checkAuthStatus();
@@ -435,6 +530,10 @@ document.addEventListener('DOMContentLoaded', () => {
     }
     
 
+    if (message.type === 'popup_view_model' && message.viewModel) {
+      cacheViewModel(message.viewModel);
+    }
+
     if (message.type === 'auth_completed') {
 
       checkAuthStatus();
@@ -484,7 +583,7 @@ document.addEventListener('DOMContentLoaded', () => {
           displayRank(rankInfo);
         } else {
           currentRank.textContent = 'Unranked';
-          rankBadgePreview.style.backgroundImage = `url('https://eloward-cdn.unleashai.workers.dev/lol/unranked.png?v=${BADGE_CACHE_VERSION}')`;
+          rankBadgePreview.style.backgroundImage = `url('${UNRANKED_BADGE_URL}')`;
           rankBadgePreview.style.transform = 'translateY(-3px)';
         }
       } else {
@@ -519,7 +618,7 @@ document.addEventListener('DOMContentLoaded', () => {
         PersistentStorage.getConnectedState(),
         PersistentStorage.getRiotUserData(),
         PersistentStorage.getTwitchUserData(),
-        browser.storage.local.get(['selectedRegion'])
+        StorageMirror.get(['selectedRegion'])
       ]);
       
       // Handle Twitch authentication state FIRST - never block this
@@ -567,7 +666,7 @@ document.addEventListener('DOMContentLoaded', () => {
         updateRiotButtonText('Connect');
         connectRiotBtn.disabled = false;
         currentRank.textContent = 'Unranked';
-        rankBadgePreview.style.backgroundImage = `url('https://eloward-cdn.unleashai.workers.dev/lol/unranked.png?v=${BADGE_CACHE_VERSION}')`;
+        rankBadgePreview.style.backgroundImage = `url('${UNRANKED_BADGE_URL}')`;
         rankBadgePreview.style.transform = 'translateY(-3px)';
         refreshRankBtn.classList.add('hidden');
         
@@ -669,7 +768,7 @@ document.addEventListener('DOMContentLoaded', () => {
     
     // Reset rank display and show unranked graphic
     currentRank.textContent = 'Unranked';
-    rankBadgePreview.style.backgroundImage = `url('https://eloward-cdn.unleashai.workers.dev/lol/unranked.png?v=${BADGE_CACHE_VERSION}')`;
+    rankBadgePreview.style.backgroundImage = `url('${UNRANKED_BADGE_URL}')`;
     rankBadgePreview.style.transform = 'translateY(-3px)';
     
     // Ensure region selector is visible when not connected
@@ -714,7 +813,7 @@ document.addEventListener('DOMContentLoaded', () => {
             
             // Show unranked rank display
             currentRank.textContent = 'Unranked';
-            rankBadgePreview.style.backgroundImage = `url('https://eloward-cdn.unleashai.workers.dev/lol/unranked.png?v=${BADGE_CACHE_VERSION}')`;
+            rankBadgePreview.style.backgroundImage = `url('${UNRANKED_BADGE_URL}')`;
             rankBadgePreview.style.transform = 'translateY(-3px)';
             refreshRankBtn.classList.add('hidden'); // Hide refresh button on disconnect
             // Show region selector again after disconnect
@@ -775,7 +874,7 @@ document.addEventListener('DOMContentLoaded', () => {
         
         
         // Store the connected region in storage and ensure the region selector reflects the current region
-        await browser.storage.local.set({ selectedRegion: region });
+        await StorageMirror.set({ selectedRegion: region });
           // Hide region selector after successful connection
           try { regionSelect.classList.add('hidden'); } catch (_) {}
               } catch (error) {
@@ -800,9 +899,9 @@ document.addEventListener('DOMContentLoaded', () => {
   function handleRegionChange() {
     const selectedRegion = regionSelect.value;
     if (selectedRegion) {
-      browser.storage.local.set({ selectedRegion });
+      StorageMirror.set({ selectedRegion });
     } else {
-      browser.storage.local.remove('selectedRegion');
+      StorageMirror.remove('selectedRegion');
     }
     updateRiotControlsBasedOnTwitchStatus();
   }
@@ -818,7 +917,7 @@ document.addEventListener('DOMContentLoaded', () => {
       let region = regionSelect.value;
       if (!region) {
         try {
-          const res = await browser.storage.local.get(['selectedRegion']);
+          const res = await StorageMirror.get(['selectedRegion']);
           region = res?.selectedRegion || '';
         } catch (_) {}
       }
@@ -917,9 +1016,6 @@ document.addEventListener('DOMContentLoaded', () => {
     await PersistentStorage.storeRiotUserData(updatedUserData);
   }
 
-  // Badge cache versioning - increment this when badge images are updated on CDN
-  const BADGE_CACHE_VERSION = '3';
-
   // Simple cache for the current user's rank badge image by tier, stored as a data URL
   async function getCachedBadgeDataUrl(tierKey, isAnimated = false) {
     try {
@@ -1004,22 +1100,7 @@ document.addEventListener('DOMContentLoaded', () => {
     // Update premium star visibility based on plus_active
     updatePremiumStar(hasPlus);
     
-    // Properly capitalize the tier
-    let formattedTier = rankData.tier.toLowerCase();
-    formattedTier = formattedTier.charAt(0).toUpperCase() + formattedTier.slice(1);
-    
-    let rankText = formattedTier;
-    
-    // Add division for ranks that have divisions (not Master, Grandmaster, Challenger)
-    if (rankData.division && !['Master', 'Grandmaster', 'Challenger'].includes(formattedTier)) {
-      rankText += ` ${rankData.division}`;
-    }
-    
-    // Add LP if available
-    if (rankData.leaguePoints !== undefined && rankData.leaguePoints !== null) {
-      rankText += ` - ${rankData.leaguePoints} LP`;
-    }
-    
+    const { formattedTier, rankText } = formatRank(rankData);
     currentRank.textContent = rankText;
     
     // Check if we should use animated badges - simply check local storage
@@ -1033,9 +1114,7 @@ document.addEventListener('DOMContentLoaded', () => {
 
     // Determine the rank badge image path with animation support
     const rankImageFileName = formattedTier.toLowerCase();
-    const extension = useAnimated ? '.webp' : '.png';
-    const suffix = useAnimated ? '_premium' : '';  // animated badges use _premium suffix
-    const imageUrl = `https://eloward-cdn.unleashai.workers.dev/lol/${rankImageFileName}${suffix}${extension}?v=${BADGE_CACHE_VERSION}`;
+    const imageUrl = rankBadgeUrl(rankImageFileName, useAnimated);
 
     // Try cached image first for instant render; fall back to network and prefetch for next time
     try {
@@ -1051,7 +1130,37 @@ document.addEventListener('DOMContentLoaded', () => {
       prefetchAndCacheBadgeImage(rankImageFileName, imageUrl, useAnimated);
     }
     
-    // Apply different positioning based on rank
+    positionRankBadge(rankImageFileName);
+  }
+
+  function formatRank(rankData) {
+    // Properly capitalize the tier
+    let formattedTier = rankData.tier.toLowerCase();
+    formattedTier = formattedTier.charAt(0).toUpperCase() + formattedTier.slice(1);
+    
+    let rankText = formattedTier;
+    
+    // Add division for ranks that have divisions (not Master, Grandmaster, Challenger)
+    if (rankData.division && !['Master', 'Grandmaster', 'Challenger'].includes(formattedTier)) {
+      rankText += ` ${rankData.division}`;
+    }
+    
+    // Add LP if available
+    if (rankData.leaguePoints !== undefined && rankData.leaguePoints !== null) {
+      rankText += ` - ${rankData.leaguePoints} LP`;
+    }
+
+    return { formattedTier, rankText };
+  }
+
+  function rankBadgeUrl(rankImageFileName, useAnimated) {
+    const extension = useAnimated ? '.webp' : '.png';
+    const suffix = useAnimated ? '_premium' : '';  // animated badges use _premium suffix
+    return `https://eloward-cdn.unleashai.workers.dev/lol/${rankImageFileName}${suffix}${extension}?v=${BADGE_CACHE_VERSION}`;
+  }
+
+  // Apply different positioning based on rank
+  function positionRankBadge(rankImageFileName) {
     const higherRanks = ['master', 'grandmaster', 'challenger'];
     if (higherRanks.includes(rankImageFileName)) {
       rankBadgePreview.style.transform = 'translateY(0)';
@@ -1137,7 +1246,7 @@ document.addEventListener('DOMContentLoaded', () => {
   }
 
   // Get references to all stored regions
-  browser.storage.local.get(['selectedRegion']).then((result) => {
+  StorageMirror.get(['selectedRegion']).then((result) => {
     // First clean up any old key that might exist
     browser.storage.local.remove('connected_region');
     
@@ -1274,8 +1383,9 @@ document.addEventListener('DOMContentLoaded', () => {
   // Load user options from local storage for instant display
   async function loadOptionsFromStorage() {
     try {
-      const stored = await browser.storage.local.get(['eloward_user_options']);
-      return stored.eloward_user_options || null;
+      const stored = await StorageMirror.get(['eloward_user_options']);
+      // A copy: callers edit it before saving, and the mirror must only change through set()
+      return stored.eloward_user_options ? { ...stored.eloward_user_options } : null;
     } catch (error) {
       console.warn('[EloWard Popup] Error loading options from storage:', error);
       return null;
@@ -1285,7 +1395,7 @@ document.addEventListener('DOMContentLoaded', () => {
   // Save user options to local storage
   async function saveOptionsToStorage(options) {
     try {
-      await browser.storage.local.set({
+      await StorageMirror.set({
         eloward_user_options: {
           show_peak: Boolean(options.show_peak),
           animate_badge: Boolean(options.animate_badge),
@@ -1301,7 +1411,7 @@ document.addEventListener('DOMContentLoaded', () => {
   // Clear user options from local storage (used on disconnect)
   async function clearOptionsFromStorage() {
     try {
-      await browser.storage.local.remove(['eloward_user_options']);
+      await StorageMirror.remove(['eloward_user_options']);
     } catch (error) {
       console.warn('[EloWard Popup] Error clearing options from storage:', error);
     }
@@ -1338,6 +1448,51 @@ document.addEventListener('DOMContentLoaded', () => {
     }
   }
 
+  // Local-only performance metrics (see js/core/metrics.js); independent of the Riot/Plus gated options
+  async function initializeMetricsOptions() {
+    const metricsToggle = document.getElementById('metrics-enabled');
+    const exportButton = document.getElementById('export-metrics');
+    if (!metricsToggle || !exportButton) return;
+
+    try {
+      const stored = await browser.storage.local.get(['eloward_metrics_enabled']);
+      metricsToggle.checked = !!stored.eloward_metrics_enabled;
+    } catch (_) {}
+    exportButton.disabled = !metricsToggle.checked;
+
+    metricsToggle.addEventListener('change', async (e) => {
+      exportButton.disabled = !e.target.checked;
+      try {
+        await browser.storage.local.set({ eloward_metrics_enabled: e.target.checked });
+      } catch (error) {
+        e.target.checked = !e.target.checked;
+        exportButton.disabled = !e.target.checked;
+      }
+    });
+
+    exportButton.addEventListener('click', async () => {
+      exportButton.disabled = true;
+      try {
+        const response = await browser.runtime.sendMessage({ action: 'get_metrics' });
+        if (!response?.success) throw new Error(response?.error || 'No metrics available');
+
+        const blob = new Blob([JSON.stringify(response.metrics, null, 2)], { type: 'application/json' });
+        const url = URL.createObjectURL(blob);
+        const link = document.createElement('a');
+        link.href = url;
+        link.download = `eloward-metrics-${new Date(response.metrics.collectedAt).toISOString().replace(/[:.]/g, '-')}.json`;
+        document.body.appendChild(link);
+        link.click();
+        link.remove();
+        setTimeout(() => URL.revokeObjectURL(url), 1000);
+      } catch (error) {
+        console.warn('[EloWard Popup] Error exporting metrics:', error);
+      } finally {
+        exportButton.disabled = !metricsToggle.checked;
+      }
+    });
+  }
+
   async function initializeUserOptions() {
     try {
       const showPeakToggle = document.getElementById('use-peak-rank');
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Relative --out paths resolve against the caller's directory
+export ELOWARD_BENCH_CWD="$PWD"
+
+# The default run stages the esbuild dist build, which needs the build dependencies
+if [ ! -d "$(dirname "$0")/node_modules" ]; then
+  echo "[bench-chat-flood] Installing build dependencies..."
+  (cd "$(dirname "$0")" && npm install --no-audit --no-fund)
+fi
+
+# Always run from the benchmark directory
+cd "$(dirname "$0")/bench"
+
+if [ ! -d node_modules ]; then
+  echo "[bench-chat-flood] Installing benchmark dependencies..."
+  npm install --no-audit --no-fund
+fi
+
+echo "[bench-chat-flood] Running chat flood benchmark..."
+node chat-flood.js "$@"
@@ -0,0 +1,283 @@
+#!/usr/bin/env node
+
+/**
+ * Chat-flood benchmark for the content script
+ * Usage: scripts/bench-chat-flood.sh [--mode twitch|seventv|ffz|vod|all] [--rates 100,500,1000,2000]
+ *        [--duration 10] [--settle 3] [--users 5000] [--ranked 60] [--latency 40] [--seed 1]
+ *        [--out results.json] [--headful] [--source]
+ *
+ * The extension is staged from the minified build pack-chrome.sh ships (build-manifest.js
+ * chrome --dist); --source loads the unminified tree instead. Results record which one ran.
+ * Each scenario starts a fresh Chrome profile with the extension loaded, serves a chat fixture
+ * as twitch.tv, answers every backend request from mock-backend.js and floods chat at the
+ * given rate. Reports long tasks, badge latency, heap growth and request counts.
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const puppeteer = require('puppeteer');
+
+const { generateChromeManifest, buildDist } = require('../build-manifest.js');
+const { createMockBackend } = require('./mock-backend.js');
+
+const ROOT_DIR = path.join(__dirname, '..', '..');
+const FIXTURES_DIR = path.join(__dirname, 'fixtures');
+const PAGE_DRIVER = fs.readFileSync(path.join(__dirname, 'page-driver.js'), 'utf8');
+
+const MODES = {
+  twitch: { fixture: 'twitch.html', path: '/benchchannel' },
+  seventv: { fixture: 'seventv.html', path: '/benchchannel' },
+  ffz: { fixture: 'ffz.html', path: '/benchchannel' },
+  vod: { fixture: 'vod.html', path: '/videos/1000000001' }
+};
+
+const DEFAULTS = {
+  mode: 'all',
+  rates: '100,500,1000,2000', // messages per second
+  duration: 10, // seconds of flood per scenario
+  settle: 3, // seconds to wait for trailing badges
+  users: 5000, // distinct chatters
+  ranked: 60, // percent of chatters with a linked rank
+  latency: 40, // mock backend response time in ms
+  seed: 1,
+  out: null,
+  headful: false,
+  source: false // Stage the unminified source tree instead of the dist build
+};
+
+function parseArgs(argv) {
+  const options = { ...DEFAULTS };
+  for (let index = 0; index < argv.length; index++) {
+    const key = argv[index].replace(/^--/, '');
+    if (!(key in DEFAULTS)) {
+      console.error(`❌ Unknown option --${key}`);
+      process.exit(1);
+    }
+    if (typeof DEFAULTS[key] === 'boolean') {
+      options[key] = true;
+    } else {
+      const value = argv[++index];
+      options[key] = typeof DEFAULTS[key] === 'number' ? Number(value) : value;
+    }
+  }
+  return options;
+}
+
+// Stage the minified dist build pack-chrome.sh ships, or with --source the unminified tree
+// with a freshly generated Chrome manifest
+async function stageExtension(fromSource) {
+  const stageDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eloward-bench-ext-'));
+  if (!fromSource) {
+    await buildDist('chrome', generateChromeManifest(), stageDir);
+    return stageDir;
+  }
+  for (const entry of fs.readdirSync(ROOT_DIR)) {
+    if (entry.startsWith('.') || entry === 'scripts' || entry === 'node_modules' || entry.endsWith('.zip')) continue;
+    fs.cpSync(path.join(ROOT_DIR, entry), path.join(stageDir, entry), { recursive: true });
+  }
+  fs.writeFileSync(path.join(stageDir, 'manifest.json'), JSON.stringify(generateChromeManifest(), null, 2));
+  return stageDir;
+}
+
+// Service worker fetches never reach page interception, so they go through the Fetch domain
+async function interceptWorkerFetches(session, backend) {
+  session.on('Fetch.requestPaused', async ({ requestId, request }) => {
+    const response = await backend.respond(request.url, request.method, request.postData);
+    try {
+      await session.send('Fetch.fulfillRequest', {
+        requestId,
+        responseCode: response.status,
+        responseHeaders: Object.entries(response.headers).map(([name, value]) => ({ name, value: String(value) })),
+        body: Buffer.from(response.body).toString('base64')
+      });
+    } catch (_) {}
+  });
+  await session.send('Fetch.enable', {
+    patterns: [{ urlPattern: 'https://*.unleashai.workers.dev/*' }, { urlPattern: 'https://gql.twitch.tv/*' }]
+  });
+}
+
+async function handlePageRequest(request, fixtureHtml, backend) {
+  const url = new URL(request.url());
+  if (url.protocol !== 'https:') return request.continue();
+  if (url.hostname === 'www.twitch.tv' && request.resourceType() === 'document') {
+    return request.respond({ status: 200, contentType: 'text/html', body: fixtureHtml });
+  }
+  const response = await backend.respond(request.url(), request.method(), request.postData());
+  return request.respond({ status: response.status, headers: response.headers, body: response.body });
+}
+
+function percentile(sortedValues, q) {
+  if (sortedValues.length === 0) return null;
+  const index = Math.min(sortedValues.length - 1, Math.max(0, Math.ceil(q * sortedValues.length) - 1));
+  return Math.round(sortedValues[index] * 10) / 10;
+}
+
+async function collectExtensionMetrics(worker) {
+  return worker.evaluate(async () => {
+    const tabs = await chrome.tabs.query({ url: '*://*.twitch.tv/*' });
+    const responses = await Promise.all(tabs.map(tab =>
+      chrome.tabs.sendMessage(tab.id, { type: 'eloward_get_metrics' }).catch(() => null)
+    ));
+    return {
+      background: EloWardMetrics.snapshot(),
+      tabs: responses.filter(Boolean).map(response => response.metrics)
+    };
+  });
+}
+
+async function runScenario(extensionDir, modeName, rate, options) {
+  const mode = MODES[modeName];
+  const fixtureHtml = fs.readFileSync(path.join(FIXTURES_DIR, mode.fixture), 'utf8');
+  const backend = createMockBackend({ latencyMs: options.latency, rankedPercent: options.ranked });
+  const userDataDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eloward-bench-profile-'));
+
+  const browser = await puppeteer.launch({
+    headless: !options.headful,
+    userDataDir,
+    args: [
+      `--disable-extensions-except=${extensionDir}`,
+      `--load-extension=${extensionDir}`,
+      // Nothing leaves the machine: every request to these hosts is answered by the mocks
+      '--host-resolver-rules=MAP *.twitch.tv ~NOTFOUND, MAP *.unleashai.workers.dev ~NOTFOUND',
+      '--no-first-run',
+      '--no-default-browser-check'
+    ]
+  });
+
+  try {
+    const workerTarget = await browser.waitForTarget(
+      target => target.type() === 'service_worker' && target.url().startsWith('chrome-extension://'),
+      { timeout: 15000 }
+    );
+    const worker = await workerTarget.worker();
+    await interceptWorkerFetches(await workerTarget.createCDPSession(), backend);
+    await worker.evaluate(() => chrome.storage.local.set({ eloward_metrics_enabled: true }));
+
+    const page = await browser.newPage();
+    await page.setViewport({ width: 1280, height: 900 });
+    await page.evaluateOnNewDocument(PAGE_DRIVER);
+    await page.setRequestInterception(true);
+    page.on('request', request => handlePageRequest(request, fixtureHtml, backend).catch(() => {}));
+
+    await page.goto(`https://www.twitch.tv${mode.path}`, { waitUntil: 'domcontentloaded' });
+    await page.waitForFunction(() => window.__elowardBench?.ready, { timeout: 10000 });
+    if (!(await page.evaluate(() => window.__elowardBench.warmUp(20000)))) {
+      throw new Error('no badge rendered during warm-up; the extension did not activate on the fixture');
+    }
+
+    const pageSession = await page.createCDPSession();
+    await pageSession.send('HeapProfiler.collectGarbage');
+    const before = await page.metrics();
+    backend.resetCounts();
+    await worker.evaluate(() => EloWardMetrics.reset());
+    await page.evaluate(() => window.__elowardBench.resetStats());
+
+    await page.evaluate(flood => window.__elowardBench.flood(flood), {
+      rate,
+      durationMs: options.duration * 1000,
+      settleMs: options.settle * 1000,
+      users: options.users,
+      rankedPercent: options.ranked,
+      seed: options.seed
+    });
+
+    const stats = await page.evaluate(() => window.__elowardBench.stats());
+    await pageSession.send('HeapProfiler.collectGarbage');
+    const after = await page.metrics();
+    const latencies = stats.latencies.slice().sort((a, b) => a - b);
+    const longTasks = stats.longTasks;
+
+    return {
+      mode: modeName,
+      rate,
+      sent: stats.sent,
+      rankedSent: stats.rankedSent,
+      badgedLines: stats.badgedLines,
+      evicted: stats.evicted,
+      badgeLatencyMs: { p50: percentile(latencies, 0.5), p99: percentile(latencies, 0.99), max: percentile(latencies, 1) },
+      longTasks: {
+        count: longTasks.length,
+        totalMs: Math.round(longTasks.reduce((sum, duration) => sum + duration, 0)),
+        maxMs: Math.round(Math.max(0, ...longTasks))
+      },
+      heapGrowthMb: Math.round(((after.JSHeapUsedSize - before.JSHeapUsedSize) / 1048576) * 100) / 100,
+      domNodeGrowth: after.Nodes - before.Nodes,
+      requests: backend.counts(),
+      extensionMetrics: await collectExtensionMetrics(worker)
+    };
+  } finally {
+    await browser.close();
+    fs.rmSync(userDataDir, { recursive: true, force: true });
+  }
+}
+
+function summaryRow(result) {
+  if (result.error) return { mode: result.mode, rate: result.rate, error: result.error };
+  return {
+    mode: result.mode,
+    rate: result.rate,
+    sent: result.sent,
+    'badged/ranked': `${result.badgedLines}/${result.rankedSent}`,
+    'p50 ms': result.badgeLatencyMs.p50,
+    'p99 ms': result.badgeLatencyMs.p99,
+    'long tasks': result.longTasks.count,
+    'long max ms': result.longTasks.maxMs,
+    'heap +MB': result.heapGrowthMb,
+    'batch reqs': result.requests['rank.batch'] || 0,
+    'single reqs': result.requests['rank.single'] || 0,
+    'cdn reqs': (result.requests['cdn.image'] || 0) + (result.requests['cdn.manifest'] || 0)
+  };
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const modes = options.mode === 'all' ? Object.keys(MODES) : options.mode.split(',');
+  for (const mode of modes) {
+    if (!MODES[mode]) {
+      console.error(`❌ Invalid mode "${mode}". Use ${Object.keys(MODES).join(', ')} or all`);
+      process.exit(1);
+    }
+  }
+  const rates = String(options.rates).split(',').map(Number).filter(rate => rate > 0);
+
+  const build = options.source ? 'source' : 'dist';
+  const extensionDir = await stageExtension(options.source);
+  console.log(`🔧 Staged ${build} build in ${extensionDir}`);
+
+  const results = [];
+  try {
+    for (const mode of modes) {
+      for (const rate of rates) {
+        console.log(`🌊 ${mode}: ${rate} msg/s for ${options.duration}s...`);
+        try {
+          results.push(await runScenario(extensionDir, mode, rate, options));
+        } catch (error) {
+          console.error(`❌ ${mode} @ ${rate} msg/s failed: ${error.message}`);
+          results.push({ mode, rate, error: error.message });
+        }
+      }
+    }
+  } finally {
+    fs.rmSync(extensionDir, { recursive: true, force: true });
+  }
+
+  console.log(`📦 Measured the ${build} build`);
+  console.table(results.map(summaryRow));
+
+  if (options.out) {
+    const outPath = path.resolve(process.env.ELOWARD_BENCH_CWD || process.cwd(), options.out);
+    fs.writeFileSync(outPath, JSON.stringify({ options, build, results }, null, 2));
+    console.log(`✅ Wrote ${outPath}`);
+  }
+
+  if (results.some(result => result.error)) process.exitCode = 1;
+}
+
+if (require.main === module) {
+  main().catch((error) => {
+    console.error('❌ Benchmark failed:', error);
+    process.exit(1);
+  });
+}
@@ -0,0 +1,135 @@
+/**
+ * Mocked EloWard backends and Twitch GQL for the chat-flood benchmark
+ * Every request the page or the service worker makes is answered here, after a fixed delay,
+ * and counted per endpoint.
+ */
+
+const TIERS = ['IRON', 'BRONZE', 'SILVER', 'GOLD', 'PLATINUM', 'EMERALD', 'DIAMOND', 'MASTER', 'GRANDMASTER', 'CHALLENGER'];
+const DIVISIONS = ['IV', 'III', 'II', 'I'];
+const APEX_TIERS = new Set(['MASTER', 'GRANDMASTER', 'CHALLENGER']);
+
+// 1x1 transparent PNG served for every badge asset
+const PIXEL_PNG = Buffer.from(
+  'iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAYAAAAfFcSJAAAAC0lEQVR4nGNgAAIAAAUAAXpeqz8AAAAASUVORK5CYII=',
+  'base64'
+);
+
+const CORS_HEADERS = {
+  'access-control-allow-origin': '*',
+  'access-control-allow-headers': '*',
+  'access-control-allow-methods': 'GET, POST, OPTIONS'
+};
+
+// Chatters are named benchuser<N>; page-driver.js applies the same rule when counting ranked lines
+function userIndex(username) {
+  const match = /^benchuser(\d+)$/.exec(String(username || '').toLowerCase());
+  return match ? Number(match[1]) : -1;
+}
+
+function isRanked(index, rankedPercent) {
+  return index >= 0 && index % 100 < rankedPercent;
+}
+
+function rankRow(username, index) {
+  const tier = TIERS[index % TIERS.length];
+  return {
+    twitch_username: username,
+    rank_tier: tier,
+    rank_division: APEX_TIERS.has(tier) ? null : DIVISIONS[index % DIVISIONS.length],
+    lp: index % 100,
+    riot_id: `Bench${index}#NA1`,
+    region: 'na1',
+    animate_badge: false
+  };
+}
+
+function createMockBackend({ latencyMs = 40, rankedPercent = 60 } = {}) {
+  let counts = {};
+  const count = (key, amount = 1) => {
+    counts[key] = (counts[key] || 0) + amount;
+  };
+
+  const json = (status, data) => ({
+    status,
+    headers: { ...CORS_HEADERS, 'content-type': 'application/json' },
+    body: JSON.stringify(data)
+  });
+
+  const rankFor = (username) => {
+    const index = userIndex(username);
+    return isRanked(index, rankedPercent) ? rankRow(username, index) : null;
+  };
+
+  function route(url, method, postData) {
+    const { hostname, pathname } = new URL(url);
+
+    if (method === 'OPTIONS') {
+      count('preflight');
+      return { status: 204, headers: CORS_HEADERS, body: '' };
+    }
+
+    if (hostname === 'gql.twitch.tv') {
+      count('twitch.gql');
+      return json(200, { data: { user: { stream: { game: { id: '21779', name: 'League of Legends', displayName: 'League of Legends' } } } } });
+    }
+
+    if (hostname === 'eloward-ranks.unleashai.workers.dev') {
+      if (pathname === '/api/ranks/lol/batch') {
+        const usernames = JSON.parse(postData || '{}').usernames || [];
+        count('rank.batch');
+        count('rank.batch_users', usernames.length);
+        const ranks = {};
+        for (const username of usernames) {
+          const row = rankFor(username);
+          if (row) ranks[username] = row;
+        }
+        return json(200, { ranks });
+      }
+      if (/^\/api\/ranks\/lol\/channel\/[^/]+$/.test(pathname)) {
+        count('rank.channel');
+        return json(200, { ranks: {} });
+      }
+      if (pathname === '/api/ranks/lol/by-puuid') {
+        count('rank.by_puuid');
+        return json(404, { error: 'not found' });
+      }
+      const single = pathname.match(/^\/api\/ranks\/lol\/([^/]+)$/);
+      if (single) {
+        count('rank.single');
+        const row = rankFor(decodeURIComponent(single[1]));
+        return row ? json(200, row) : json(404, { error: 'not found' });
+      }
+    }
+
+    if (hostname === 'eloward-cdn.unleashai.workers.dev') {
+      // No badge pack: the content script falls back to per-tier images
+      if (pathname.endsWith('/manifest.json')) {
+        count('cdn.manifest');
+        return json(404, { error: 'not found' });
+      }
+      count('cdn.image');
+      return { status: 200, headers: { ...CORS_HEADERS, 'content-type': 'image/png' }, body: PIXEL_PNG };
+    }
+
+    if (hostname === 'eloward-users.unleashai.workers.dev') {
+      count('viewer');
+      return json(200, { success: true });
+    }
+
+    count('other');
+    return json(404, { error: 'not mocked' });
+  }
+
+  return {
+    respond(url, method = 'GET', postData) {
+      const response = route(url, method, postData);
+      return new Promise(resolve => setTimeout(() => resolve(response), latencyMs));
+    },
+    counts: () => ({ ...counts }),
+    resetCounts() {
+      counts = {};
+    }
+  };
+}
+
+module.exports = { createMockBackend };
@@ -0,0 +1,144 @@
+/**
+ * Flood driver injected into the fixture page's main world before any script runs
+ * Appends chat lines cloned from the fixture's <template id="bench-message"> into its
+ * [data-bench-container], and times each line until the content script badges it.
+ * The content script shares this thread, so long tasks observed here include its work.
+ */
+
+(() => {
+  const MAX_CHAT_LINES = 150; // Twitch keeps roughly this many lines mounted
+  const TICK_MS = 16;
+
+  let template = null;
+  let container = null;
+  let sequence = 0;
+  let badged = new WeakSet();
+  const stats = { sent: 0, rankedSent: 0, evicted: 0, latencies: [], longTasks: [] };
+
+  try {
+    new PerformanceObserver((list) => {
+      for (const entry of list.getEntries()) stats.longTasks.push(entry.duration);
+    }).observe({ type: 'longtask' });
+  } catch (_) {}
+
+  function noteBadges(node) {
+    const badges = node.matches('.eloward-rank-badge') ? [node] : node.querySelectorAll('.eloward-rank-badge');
+    const now = performance.now();
+    for (const badge of badges) {
+      const line = badge.closest('[data-bench-t]');
+      if (!line || badged.has(line)) continue;
+      badged.add(line);
+      stats.latencies.push(now - Number(line.dataset.benchT));
+    }
+  }
+
+  new MutationObserver((records) => {
+    for (const record of records) {
+      for (const node of record.addedNodes) {
+        if (node.nodeType === Node.ELEMENT_NODE) noteBadges(node);
+      }
+    }
+  }).observe(document, { childList: true, subtree: true });
+
+  // Seeded so every run replays the same chatters in the same order
+  function mulberry32(seed) {
+    let state = seed >>> 0;
+    return () => {
+      state = (state + 0x6D2B79F5) >>> 0;
+      let t = state;
+      t = Math.imul(t ^ (t >>> 15), t | 1);
+      t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+      return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+    };
+  }
+
+  // Must match isRanked() in mock-backend.js
+  function isRanked(index, rankedPercent) {
+    return index % 100 < rankedPercent;
+  }
+
+  function appendLine(index, rankedPercent) {
+    const fragment = template.content.cloneNode(true);
+    const line = fragment.firstElementChild;
+    const login = `benchuser${index}`;
+    for (const element of fragment.querySelectorAll('[data-bench-name]')) {
+      element.textContent = `BenchUser${index}`;
+      if (element.hasAttribute('data-a-user')) element.setAttribute('data-a-user', login);
+    }
+    for (const element of fragment.querySelectorAll('[data-bench-text]')) {
+      element.textContent = `message ${++sequence} KEKW`;
+    }
+    line.dataset.benchT = String(performance.now());
+    container.appendChild(fragment);
+
+    stats.sent++;
+    if (isRanked(index, rankedPercent)) stats.rankedSent++;
+
+    while (container.childElementCount > MAX_CHAT_LINES) {
+      container.firstElementChild.remove();
+      stats.evicted++;
+    }
+  }
+
+  // Append a ranked regular's line every 500ms until one is badged: init waits on game detection
+  function warmUp(timeoutMs) {
+    const startedAt = performance.now();
+    return new Promise((resolve) => {
+      const attempt = () => {
+        if (stats.latencies.length > 0) return resolve(true);
+        if (performance.now() - startedAt > timeoutMs) return resolve(false);
+        appendLine(0, 100);
+        setTimeout(attempt, 500);
+      };
+      attempt();
+    });
+  }
+
+  // Lines arrive per frame like Twitch's own renderer; a few regulars send most of them
+  function flood({ rate, durationMs, settleMs, users, rankedPercent, seed }) {
+    const random = mulberry32(seed);
+    const total = Math.floor((rate * durationMs) / 1000);
+    const startedAt = performance.now();
+    let sentThisFlood = 0;
+
+    return new Promise((resolve) => {
+      const tick = () => {
+        const due = Math.min(total, Math.floor(((performance.now() - startedAt) * rate) / 1000));
+        while (sentThisFlood < due) {
+          const r = random();
+          appendLine(Math.floor(r * r * users), rankedPercent);
+          sentThisFlood++;
+        }
+        if (sentThisFlood < total) {
+          setTimeout(tick, TICK_MS);
+        } else {
+          setTimeout(resolve, settleMs);
+        }
+      };
+      tick();
+    });
+  }
+
+  function resetStats() {
+    badged = new WeakSet();
+    stats.sent = 0;
+    stats.rankedSent = 0;
+    stats.evicted = 0;
+    stats.latencies = [];
+    stats.longTasks = [];
+  }
+
+  window.__elowardBench = {
+    ready: false,
+    warmUp,
+    flood,
+    resetStats,
+    stats: () => ({ ...stats, badgedLines: stats.latencies.length })
+  };
+
+  document.addEventListener('DOMContentLoaded', () => {
+    template = document.getElementById('bench-message');
+    container = document.querySelector('[data-bench-container]');
+    window.__elowardBench.ready = !!(template && container);
+  });
+})();
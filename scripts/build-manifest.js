@@ -2,7 +2,11 @@
 
 /**
  * Build script to generate browser-specific manifests
- * Usage: node build-manifest.js [chrome|firefox]
+ * Usage: node build-manifest.js [chrome|firefox] [--dist]
+ *
+ * Without --dist the manifest is written to the repo root for loading the source tree unpacked.
+ * With --dist a minified production build is written to dist/<target> (needs esbuild: run
+ * "npm install" in scripts/ once).
  */
 
 const fs = require('fs');
@@ -10,6 +14,14 @@ const path = require('path');
 
 const ROOT_DIR = path.join(__dirname, '..');
 
+const POLYFILL = "vendor/browser-polyfill.js";
+const BADGE_ADAPTERS = "js/content/adapters/*.js";
+
+// Content scripts that only call chrome.* and so skip the polyfill where chrome.* is native
+const CHROME_NATIVE_CONTENT_SCRIPTS = new Set(["js/content/bootstrap.js"]);
+// Chat engine injected by the background once bootstrap.js finds a chat route (CHAT_ENGINE_FILES)
+const INJECTED_SCRIPTS = ["js/core/metrics.js", "js/core/storageMirror.js", "js/content/content.js"];
+
 // Base manifest configuration
 const baseManifest = {
   name: "EloWard",
@@ -23,12 +35,12 @@ const baseManifest = {
   content_scripts: [
     {
       matches: ["*://*.twitch.tv/*"],
-      js: ["vendor/browser-polyfill.js", "js/content/content.js"],
+      js: [POLYFILL, "js/content/bootstrap.js"],
       css: ["css/content.css"]
     },
     {
       matches: ["https://www.eloward.com/*"],
-      js: ["vendor/browser-polyfill.js", "js/core/extensionBridge.js"],
+      js: [POLYFILL, "js/core/extensionBridge.js"],
       run_at: "document_start"
     }
   ],
@@ -36,6 +48,11 @@ const baseManifest = {
     {
       resources: ["images/logo/*.png"],
       matches: ["<all_urls>"]
+    },
+    {
+      // Imported by content.js once the chat mode is known
+      resources: [BADGE_ADAPTERS],
+      matches: ["*://*.twitch.tv/*"]
     }
   ],
   content_security_policy: {
@@ -55,13 +72,19 @@ function generateChromeManifest() {
         "128": "images/logo/icon128.png"
       }
     },
-    permissions: ["storage", "tabs"],
+    permissions: ["storage", "tabs", "scripting", "alarms"],
     host_permissions: [
       "https://www.twitch.tv/*",
       "https://gql.twitch.tv/*",
       "https://*.unleashai.workers.dev/*",
       "https://www.eloward.com/*"
     ],
+    content_scripts: baseManifest.content_scripts.map(script => ({
+      ...script,
+      js: script.js.some(file => CHROME_NATIVE_CONTENT_SCRIPTS.has(file))
+        ? script.js.filter(file => file !== POLYFILL)
+        : script.js
+    })),
     background: {
       service_worker: "js/background/background.js",
       type: "module"
@@ -84,6 +107,8 @@ function generateFirefoxManifest() {
     permissions: [
       "storage",
       "tabs",
+      "alarms",
+      "webNavigation",
       "https://www.twitch.tv/*",
       "https://gql.twitch.tv/*",
       "https://*.unleashai.workers.dev/*",
@@ -103,7 +128,7 @@ function generateFirefoxManifest() {
   };
 
   // Convert MV3 web_accessible_resources format to MV2
-  manifest.web_accessible_resources = ["images/logo/*.png"];
+  manifest.web_accessible_resources = ["images/logo/*.png", BADGE_ADAPTERS];
   
   // Convert MV3 CSP format to MV2
   manifest.content_security_policy = "script-src 'self'; object-src 'self'; img-src 'self' data: https://eloward-cdn.unleashai.workers.dev";
@@ -114,8 +139,93 @@ function generateFirefoxManifest() {
   return manifest;
 }
 
-function main() {
-  const target = process.argv[2] || 'chrome';
+// Copied into dist unchanged; all JS is produced by esbuild below
+const DIST_STATIC_FILES = ["images", "css", "popup.html", "background.html", "LICENSE", POLYFILL];
+// ES module entry points, bundled with their imports and tree-shaken
+const DIST_MODULE_ENTRIES = ["js/background/background.js", "js/popup.js"];
+const DIST_TARGETS = { chrome: "chrome110", firefox: "firefox115" };
+
+// outDir defaults to dist/<target>; the chat-flood benchmark stages into a temp directory
+async function buildDist(target, manifest, outDir = path.join(ROOT_DIR, 'dist', target)) {
+  let esbuild;
+  try {
+    esbuild = require('esbuild');
+  } catch (_) {
+    console.error('❌ esbuild is not installed. Run "npm install" in scripts/ first');
+    process.exit(1);
+  }
+
+  const esTarget = DIST_TARGETS[target];
+  fs.rmSync(outDir, { recursive: true, force: true });
+  fs.mkdirSync(outDir, { recursive: true });
+
+  for (const file of DIST_STATIC_FILES) {
+    if (file === "background.html" && !manifest.background.page) continue;
+    fs.cpSync(path.join(ROOT_DIR, file), path.join(outDir, file), { recursive: true });
+  }
+
+  // The polyfill stays one shared file: background.html and popup.html also load it with a script tag
+  const polyfillAsExternal = (outfile) => ({
+    name: 'polyfill-external',
+    setup(build) {
+      build.onResolve({ filter: /browser-polyfill\.js$/ }, () => {
+        const relative = path.relative(path.dirname(outfile), path.join(outDir, POLYFILL)).split(path.sep).join('/');
+        return { path: relative.startsWith('.') ? relative : `./${relative}`, external: true };
+      });
+    }
+  });
+
+  const adapterEntries = fs.readdirSync(path.join(ROOT_DIR, path.dirname(BADGE_ADAPTERS)))
+    .filter(file => file.endsWith('.js'))
+    .map(file => `${path.dirname(BADGE_ADAPTERS)}/${file}`);
+
+  for (const entry of [...DIST_MODULE_ENTRIES, ...adapterEntries]) {
+    const outfile = path.join(outDir, entry);
+    await esbuild.build({
+      entryPoints: [path.join(ROOT_DIR, entry)],
+      outfile,
+      bundle: true,
+      format: 'esm',
+      minify: true,
+      target: esTarget,
+      legalComments: 'none',
+      logLevel: 'warning',
+      plugins: [polyfillAsExternal(outfile)]
+    });
+  }
+
+  // Classic content scripts share one global scope per page, so each context's files are joined
+  // into a single script; transform() minifies without renaming top-level names
+  const distManifest = JSON.parse(JSON.stringify(manifest));
+  for (const script of distManifest.content_scripts) {
+    const source = script.js.map(file => fs.readFileSync(path.join(ROOT_DIR, file), 'utf8')).join(';\n');
+    const bundleFile = script.js[script.js.length - 1];
+    const { code } = await esbuild.transform(source, { minify: true, target: esTarget, legalComments: 'none' });
+    fs.mkdirSync(path.dirname(path.join(outDir, bundleFile)), { recursive: true });
+    fs.writeFileSync(path.join(outDir, bundleFile), code);
+    script.js = [bundleFile];
+  }
+
+  // Injected files keep their paths; each is minified on its own
+  for (const file of INJECTED_SCRIPTS) {
+    const { code } = await esbuild.transform(fs.readFileSync(path.join(ROOT_DIR, file), 'utf8'), {
+      minify: true,
+      target: esTarget,
+      legalComments: 'none'
+    });
+    fs.mkdirSync(path.dirname(path.join(outDir, file)), { recursive: true });
+    fs.writeFileSync(path.join(outDir, file), code);
+  }
+
+  fs.writeFileSync(path.join(outDir, 'manifest.json'), JSON.stringify(distManifest, null, 2));
+  const relative = path.relative(ROOT_DIR, outDir);
+  console.log(`✅ Built ${relative.startsWith('..') ? outDir : relative}`);
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  const dist = args.includes('--dist');
+  const target = args.find(arg => !arg.startsWith('--')) || 'chrome';
   
   let manifest;
   let filename;
@@ -136,6 +246,11 @@ function main() {
       process.exit(1);
   }
   
+  if (dist) {
+    await buildDist(target.toLowerCase(), manifest);
+    return;
+  }
+
   // Write the manifest
   const manifestPath = path.join(ROOT_DIR, filename);
   fs.writeFileSync(manifestPath, JSON.stringify(manifest, null, 2));
@@ -144,7 +259,10 @@ function main() {
 }
 
 if (require.main === module) {
-  main();
+  main().catch((error) => {
+    console.error('❌ Build failed:', error);
+    process.exit(1);
+  });
 }
 
-module.exports = { generateChromeManifest, generateFirefoxManifest };
\ No newline at end of file
+module.exports = { generateChromeManifest, generateFirefoxManifest, buildDist };
\ No newline at end of file
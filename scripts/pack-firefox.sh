@@ -4,11 +4,16 @@ set -euo pipefail
 # Always run from the script's directory
 cd "$(dirname "$0")"
 
-echo "[pack-firefox] Generating Firefox manifest..."
-node build-manifest.js firefox
+if [ ! -d node_modules ]; then
+  echo "[pack-firefox] Installing build dependencies..."
+  npm install --no-audit --no-fund
+fi
+
+echo "[pack-firefox] Building minified Firefox bundle..."
+node build-manifest.js firefox --dist
 
 ZIP_NAME="EloWardApp-firefox.zip"
-APP_ROOT="$(cd .. && pwd)"
+APP_ROOT="$(cd ../dist/firefox && pwd)"
 
 echo "[pack-firefox] Removing previous zip (if any)..."
 rm -f "$ZIP_NAME"
@@ -16,7 +21,7 @@ rm -f "$ZIP_NAME"
 # Prevent macOS from adding resource forks / __MACOSX
 export COPYFILE_DISABLE=1
 
-echo "[pack-firefox] Creating clean zip from app root..."
+echo "[pack-firefox] Creating clean zip from the dist build..."
 pushd "$APP_ROOT" >/dev/null
 zip -r -X -9 "${OLDPWD}/${ZIP_NAME}" . \
   -x "__MACOSX/*" \